@@ -34,8 +34,10 @@ struct CompareOptions {
     fs::path outdir { "pandora" };
     uint32_t window_size { 14 };
     uint32_t kmer_size { 15 };
+    uint32_t query_window_size { 0 };
     uint32_t threads { 1 };
     fs::path vcf_refs_file;
+    fs::path loci_file;
     uint8_t verbosity { 0 };
     float error_rate { 0.11 };
     uint32_t genome_size { 5000000 };
@@ -43,6 +45,7 @@ struct CompareOptions {
     bool output_vcf { false };
     bool illumina { false };
     bool clean { false };
+    bool clean_by_component { false };
     bool binomial { false };
     uint32_t max_covg { 300 };
     bool genotype { false };
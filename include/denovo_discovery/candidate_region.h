@@ -103,6 +103,11 @@ public:
     void add_pileup_entry(
         const std::string& read, const ReadCoordinate& read_coordinate);
 
+    // estimate, in bytes, of the memory taken by the pileup of this region once loaded
+    uint64_t get_estimated_pileup_memory() const;
+
+    void release_pileup();
+
     virtual std::vector<std::string> get_variants(const string& denovo_sequence) const;
 
     void write_denovo_paths_to_buffer(CandidateRegionWriteBuffer& buffer);
@@ -148,6 +153,21 @@ public:
 
     PileupConstructionMap pileup_construction_map(CandidateRegions& candidate_regions);
 
+    PileupConstructionMap pileup_construction_map(
+        const std::vector<CandidateRegion*>& candidate_regions);
+
+    // sorts the candidate regions by decreasing estimated cost of assembly, pileup
+    // size times interval length, keeping the order of regions of equal cost
+    static void sort_candidate_regions_by_decreasing_cost(
+        std::vector<CandidateRegion*>& candidate_regions);
+
+    // splits the candidate regions into waves whose pileups are estimated to take at
+    // most max_pileup_memory bytes (0 for no limit), so that the pileups of a wave can
+    // be loaded, assembled and released before the next one. A region above the limit
+    // makes a wave on its own
+    static std::vector<std::vector<CandidateRegion*>> get_candidate_region_waves(
+        CandidateRegions& candidate_regions, const uint64_t max_pileup_memory);
+
     void load_candidate_region_pileups(const fs::path& reads_filepath,
         const CandidateRegions& candidate_regions,
         const PileupConstructionMap& pileup_construction_map, uint32_t threads = 1);
@@ -171,7 +191,11 @@ protected:
             output_filehandler << locus_name_and_ML_path.second << std::endl;
             output_filehandler << locus_name_to_variants.at(locus_name).size()
                                << " denovo variants for this locus" << std::endl;
-            for (const auto& variant : locus_name_to_variants.at(locus_name)) {
+            // sorted, so that the output does not depend on which child process or
+            // wave of candidate regions found each variant
+            std::vector<std::string> variants = locus_name_to_variants.at(locus_name);
+            std::sort(variants.begin(), variants.end());
+            for (const auto& variant : variants) {
                 output_filehandler << variant << std::endl;
             }
         }
@@ -24,6 +24,7 @@ struct DiscoverOptions {
     fs::path outdir { "pandora_discover" };
     uint32_t window_size { 14 };
     uint32_t kmer_size { 15 };
+    uint32_t query_window_size { 0 };
     uint32_t threads { 1 };
     uint8_t verbosity { 0 };
     float error_rate { 0.11 };
@@ -33,6 +34,7 @@ struct DiscoverOptions {
     bool output_mapped_read_fa { false };
     bool illumina { false };
     bool clean { false };
+    bool clean_by_component { false };
     bool binomial { false };
     uint32_t max_covg { 600 };
     uint16_t denovo_kmer_size { 15 };
@@ -46,6 +48,7 @@ struct DiscoverOptions {
     uint32_t min_cluster_size { 10 };
     uint32_t max_num_kmers_to_avg { 100 };
     bool clean_dbg { false };
+    uint32_t max_pileup_memory { 0 }; // in MB, 0 for no limit
 };
 
 void setup_discover_subcommand(CLI::App& app);
@@ -2,6 +2,7 @@
 #define __FASTAQ_HANDLER_H_INCLUDED__
 
 #include <string>
+#include <vector>
 #include <cstdint>
 #include <fstream>
 #include <sstream>
@@ -10,6 +11,7 @@
 #include <boost/log/core.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/log/expressions.hpp>
+#include <boost/utility/string_ref.hpp>
 #include <cstdio>
 #include <zlib.h>
 #include "kseq.h"
@@ -17,24 +19,62 @@ KSEQ_INIT(gzFile, gzread)
 
 namespace logging = boost::log;
 
+// Reads records from one or more fast{a,q} files. Several files are given as a
+// comma-separated list and are streamed one after the other, as if they had been
+// concatenated, so read indices keep counting across file boundaries.
+// Uncompressed files are memory-mapped and parsed in place; gzipped files (and
+// anything that cannot be mapped, e.g. pipes) are read through zlib and kseq.
 struct FastaqHandler {
 private:
     bool closed;
     kseq_t* inbuf;
+    std::vector<std::string> filepaths;
+    size_t current_file_idx;
+
+    // memory-mapped input - mapped_data is nullptr when reading through zlib
+    const char* mapped_data;
+    size_t mapped_size;
+    size_t mapped_pos;
+    // holds the sequence of a mapped record spanning several lines
+    std::string multiline_sequence;
+
+    void open_file(const size_t file_idx);
+
+    bool map_current_file();
+
+    int read_mapped_record();
+
+    void close_current_file();
+
+    bool has_next_file() const;
 
 public:
-    const std::string filepath;
+    std::string filepath; // the file currently being read
     gzFile fastaq_file;
     std::string name;
     std::string read;
+    // views over the name and sequence of the last record parsed by get_next_view()
+    // or get_next(). They are only valid until the next record is parsed
+    boost::string_ref name_view;
+    boost::string_ref read_view;
     uint32_t num_reads_parsed;
 
     FastaqHandler(const std::string);
 
+    FastaqHandler(const std::vector<std::string>&);
+
+    // splits a comma-separated list of files, unless it is the path of an existing
+    // file. A file whose name has a comma can thus only be given on its own
+    static std::vector<std::string> split_filepaths(const std::string&);
+
     ~FastaqHandler();
 
     bool eof() const;
 
+    // parses the next record, only updating name_view and read_view
+    void get_next_view();
+
+    // parses the next record, copying it into name and read
     void get_next();
 
     void get_nth_read(const uint32_t& idx);
@@ -42,6 +82,19 @@ public:
     void close();
 
     bool is_closed() const;
+
+    bool is_memory_mapped() const;
+
+    // offset of the next record in the current file, only for memory-mapped files
+    size_t get_mapped_position() const;
+
+    // carries on reading the current memory-mapped file from the record starting at
+    // the given offset, e.g. one given by get_mapped_position()
+    void seek_mapped_position(const size_t position);
+
+    // whether a record header starts at the given offset of the current memory-mapped
+    // file, at the start of a line
+    bool mapped_position_starts_record(const size_t position) const;
 };
 
 #endif
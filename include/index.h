@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <boost/filesystem.hpp>
 #include "minirecord.h"
@@ -19,6 +20,16 @@ public:
         minhash; // map of minimizers to MiniRecords - for each minimizer, records some
                  // information of it
 
+    // size of the s-mers if the PRGs were sketched with open syncmers, or 0 if they
+    // were sketched with (w,k)-minimizers. It is saved in the index file, so that
+    // reads are sketched the same way as the PRGs
+    uint32_t syncmer_size { 0 };
+
+    // window size given to pandora index with syncmers. It does not change their
+    // sketch, only the names of the files, so it is saved in the index file to reject
+    // another window size when loading it. 0 for (w,k)-minimizer indices
+    uint32_t window_size { 0 };
+
     // declares all default constructors, destructors and assignment operators
     // explicitly
     Index() = default; // default constructor
@@ -35,9 +46,15 @@ public:
 
     void save(const fs::path& indexfile);
 
-    void load(fs::path prgfile, uint32_t w, uint32_t k);
+    // if prg_ids_to_load is not empty, only the records of these PRGs are loaded. A
+    // syncmer index must have been built with the window size w
+    void load(fs::path prgfile, uint32_t w, uint32_t k,
+        const std::unordered_set<uint32_t>& prg_ids_to_load = {});
 
-    void load(const fs::path& indexfile);
+    // indices sketched differently (e.g. with and without syncmers) cannot be loaded
+    // into the same Index
+    void load(const fs::path& indexfile,
+        const std::unordered_set<uint32_t>& prg_ids_to_load = {});
 
     void clear();
 
@@ -46,7 +63,14 @@ public:
     bool operator!=(const Index& other) const;
 };
 
+// PRGs are sketched with open syncmers if index->syncmer_size is not 0, and with
+// (w,k)-minimizers otherwise. first_prg_position is the position of prgs[0] in the PRG
+// file, which decides the directory of outdir the k-mer graphs are saved in when only a
+// slice of it is indexed.
+// If save_vcf_sites, the VCF sites of each PRG are saved next to its k-mer graph, along
+// the path of its sequence in vcf_refs if there is one, or else along its top path
 void index_prgs(std::vector<std::shared_ptr<LocalPRG>>& prgs,
     std::shared_ptr<Index>& index, uint32_t w, uint32_t k, const fs::path& outdir,
-    uint32_t threads = 1);
+    uint32_t threads = 1, const uint32_t first_prg_position = 0,
+    const bool save_vcf_sites = false, const VCFRefs& vcf_refs = {});
 #endif
@@ -22,8 +22,12 @@ struct IndexOptions {
     fs::path prgfile;
     uint32_t window_size { 14 };
     uint32_t kmer_size { 15 };
+    uint32_t syncmer_size { 0 };
     uint32_t threads { 1 };
     uint32_t id_offset { 0 };
+    std::string slice;
+    bool save_vcf_sites { false };
+    fs::path vcf_refs_file;
     fs::path outfile;
     uint8_t verbosity { 0 };
 };
@@ -0,0 +1,28 @@
+#ifndef __KMER_HASHING_H_INCLUDED__ // if kmer_hashing.h hasn't been included yet...
+#define __KMER_HASHING_H_INCLUDED__
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// implementations of the batched k-mer hashing. Vector kernels hash several k-mers per
+// instruction (2 with SSE2, 4 with AVX2) and are only used on x86-64 CPUs supporting
+// them; all kernels give exactly the same hashes as hash64
+enum class KmerHashingKernel { scalar, sse2, avx2 };
+
+std::string to_string(const KmerHashingKernel kernel);
+
+bool kmer_hashing_kernel_is_supported(const KmerHashingKernel kernel);
+
+// the fastest kernel supported by this CPU, detected once at runtime
+KmerHashingKernel get_best_kmer_hashing_kernel();
+
+// hashes[i] = hash64(kmers[i], mask) for i < number_of_kmers. kmers and hashes can be
+// the same array, to hash in place
+void hash_kmers(const uint64_t* kmers, uint64_t* hashes, const size_t number_of_kmers,
+    const uint64_t mask);
+
+void hash_kmers(const uint64_t* kmers, uint64_t* hashes, const size_t number_of_kmers,
+    const uint64_t mask, const KmerHashingKernel kernel);
+
+#endif
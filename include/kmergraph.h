@@ -7,6 +7,7 @@ class LocalPRG;
 #include <vector>
 #include <iostream>
 #include <set>
+#include <unordered_map>
 #include <boost/filesystem.hpp>
 #include "prg/path.h"
 #include "kmernode.h"
@@ -31,6 +32,12 @@ class KmerGraph {
 private:
     uint32_t reserved_size;
     uint32_t k;
+    // index from the hash of a node path to the nodes with that hash, so that add_node
+    // does not have to compare the path against every node already in the graph
+    std::unordered_multimap<size_t, KmerNodePtr> path_hash_to_nodes;
+
+    // adds a node to nodes and to the ordering and index over them
+    void index_node(const KmerNodePtr& node);
 
 public:
     uint32_t shortest_path_length;
@@ -89,6 +96,7 @@ public:
     friend class KmerGraphWithCoverageTest_findMaxPath2Level_bin_Test;
     friend class KmerGraphWithCoverageTest_findMaxPath2Level_nbin_Test;
     friend class KmerGraphWithCoverageTest_findMaxPath2Level_lin_Test;
+    friend class KmerGraphWithCoverageTest_findMaxPathFromVotes_sameAsLinOnVoteCoverages_Test;
 };
 
 #endif
\ No newline at end of file
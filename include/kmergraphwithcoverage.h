@@ -6,6 +6,7 @@ class LocalPRG;
 
 #include <cstdint>
 #include <vector>
+#include <unordered_map>
 #include <iostream>
 #include "prg/path.h"
 #include "kmernode.h"
@@ -25,11 +26,14 @@ class LocalPRG;
  */
 class KmerGraphWithCoverage {
 private:
-    // each coverage is represented as a std::vector, each position of the vector
-    // representing the coverage of a sample each coverage of a sample is represented by
-    // a std::pair, for the forward and reverse reads coverage of that sample
-    std::vector<std::vector<std::pair<uint16_t, uint16_t>>>
-        node_index_to_sample_coverage;
+    // the coverages are stored per sample, and only for the samples that have some
+    // coverage set in this graph: a sample id maps to a block with the coverage of each
+    // node (indexed by node id), each coverage represented by a std::pair for the
+    // forward and reverse reads coverage of that sample on that node. Samples without
+    // a block have zero coverage on every node. This keeps the memory proportional to
+    // the samples in which a locus is present instead of to all samples (see compare)
+    using SampleCoverage = std::vector<std::pair<uint16_t, uint16_t>>;
+    std::unordered_map<uint32_t, SampleCoverage> sample_id_to_coverage;
     uint32_t exp_depth_covg;
     float binomial_parameter_p;
     float negative_binomial_parameter_p;
@@ -42,6 +46,17 @@ private:
     void increment_covg(uint32_t node_id, pandora::Strand strand, uint32_t sample_id);
     void set_covg(
         uint32_t node_id, uint16_t value, pandora::Strand strand, uint32_t sample_id);
+    // returns the coverage block of the given sample, creating it if absent
+    SampleCoverage& get_or_create_sample_coverage(uint32_t sample_id);
+    // finds the path maximising the mean log prob of its nodes (over windows of at
+    // most max_num_kmers_to_average nodes), given the log prob of each node by id
+    void find_max_path_given_log_probs(std::vector<KmerNodePtr>& maxpath,
+        const std::vector<float>& node_log_probs,
+        const uint32_t& max_num_kmers_to_average) const;
+    // divides the summed log prob of the nodes of kpath by its length, not counting
+    // the null start and end nodes
+    static float normalise_by_path_length(
+        const std::vector<KmerNodePtr>& kpath, const float sum_of_log_probs);
 
 public:
     KmerGraph* kmer_prg; // the underlying KmerGraph - TODO: it is dangerous to leave
@@ -49,8 +64,7 @@ public:
 
     // constructor, destructors, etc
     KmerGraphWithCoverage(KmerGraph* kmer_prg, uint32_t total_number_samples = 1)
-        : node_index_to_sample_coverage(kmer_prg->nodes.size())
-        , exp_depth_covg { 0 }
+        : exp_depth_covg { 0 }
         , binomial_parameter_p { 1 }
         , negative_binomial_parameter_p { 0.015 }
         , negative_binomial_parameter_r { 2 }
@@ -63,7 +77,6 @@ public:
         if (kmer_prg_is_invalid) {
             fatal_error("Error building Kmer Graph With Coverage: kmer PRG is invalid");
         }
-        zeroCoverages();
     }
     KmerGraphWithCoverage(const KmerGraphWithCoverage& other)
         = default; // copy default constructor
@@ -121,14 +134,12 @@ public:
     void set_thresh(int thresh) { this->thresh = thresh; }
     void set_num_reads(uint32_t num_reads) { this->num_reads = num_reads; }
 
-    void zeroCoverages()
+    void zeroCoverages() { sample_id_to_coverage.clear(); }
+
+    // number of samples with some coverage stored in this graph
+    size_t get_number_of_samples_with_coverage() const
     {
-        for (auto& sampleCoverage : node_index_to_sample_coverage) {
-            sampleCoverage
-                = std::vector<std::pair<uint16_t, uint16_t>>(total_number_samples);
-            sampleCoverage.shrink_to_fit(); // tries to make this information as compact
-                                            // as possible (TODO: use sdsl?)
-        }
+        return sample_id_to_coverage.size();
     }
 
     float nbin_prob(uint32_t, const uint32_t& sample_id);
@@ -148,6 +159,13 @@ public:
         const std::string& prob_model, const uint32_t& max_num_kmers_to_average,
         const uint32_t& sample_id);
 
+    // finds the same path as find_max_path with the "lin" model would if the coverage
+    // of each node was node_votes[node id] reads on each strand and the number of reads
+    // was num_reads, without touching (or copying) the coverages of this graph
+    float find_max_path_from_votes(std::vector<KmerNodePtr>& maxpath,
+        const std::vector<uint32_t>& node_votes, const uint32_t& num_reads,
+        const uint32_t& max_num_kmers_to_average) const;
+
     std::vector<std::vector<KmerNodePtr>> find_max_paths(
         uint32_t, const uint32_t& sample_id);
 
@@ -6,6 +6,7 @@
 #include <vector>
 #include <iostream>
 #include <memory>
+#include <unordered_map>
 #include "interval.h"
 #include "index.h"
 #include "localgraph.h"
@@ -20,6 +21,23 @@
 using PanNodePtr = std::shared_ptr<pangenome::Node>;
 namespace fs = boost::filesystem;
 
+/**
+ * A variant site found along a reference path of a LocalPRG: the skeleton of a VCF
+ * record, before any sample is added to it
+ */
+struct VCFSite {
+    uint32_t pos;
+    std::string ref;
+    std::string alt;
+    std::string graph_type;
+
+    bool operator==(const VCFSite& other) const
+    {
+        return pos == other.pos and ref == other.ref and alt == other.alt
+            and graph_type == other.graph_type;
+    }
+};
+
 /**
  * Represents a PRG of the many given as input to pandora
  */
@@ -35,13 +53,46 @@ private:
         const std::vector<Interval>& subintervals,
         const Interval& envelopping_interval);
 
+    // Index of seq built in a single pass: the start of every site marker (" n "), by
+    // site number, and the number of non-alphabetic characters before each position.
+    // Lets the graph construction split intervals by site and check that they are
+    // alphabetic without searching or copying seq.
+    struct SiteMarkerIndex {
+        std::unordered_map<uint32_t, std::vector<uint32_t>> site_to_marker_starts;
+        std::vector<uint32_t> non_alpha_prefix_count;
+
+        explicit SiteMarkerIndex(const std::string& seq);
+
+        // start of the first marker of site at or after from, or npos if there is none
+        std::string::size_type find(
+            const uint32_t site, const std::string::size_type from) const;
+
+        bool is_alpha(const Interval& interval) const;
+    };
+
+    std::vector<Interval> split_by_site(
+        const Interval&, const SiteMarkerIndex& site_markers) const;
+
+    std::vector<uint32_t> build_graph(const Interval&, const std::vector<uint32_t>&,
+        const SiteMarkerIndex& site_markers, uint32_t current_level);
+
+    uint32_t seq_length; // length of seq, also known once seq is released
+    bool seq_is_released;
+
+    std::string string_along_path_from_nodes(const prg::Path&) const;
+
+    // reads the VCF sites saved in vcf_sites_file into sites if they were saved along
+    // ref. The sites are only parsed once the saved path is known to be ref
+    bool load_saved_vcf_sites(
+        const std::vector<LocalNodePtr>& ref, std::vector<VCFSite>& sites) const;
+
 public:
     uint32_t next_site; // denotes the id of the next variant site to be processed -
                         // TODO: maybe this should not be an object variable
     uint32_t id; // id of this LocalPRG in the full graph (first gene is 0, second is 1,
                  // and so on...)
     std::string name; // name (fasta comment)
-    std::string seq; // seq of LocalPRG (the PRG as string itself)
+    std::string seq; // seq of LocalPRG (the PRG as string itself), empty once released
     LocalGraph prg; // the graph that represents this LocalPRG
     KmerGraph kmer_prg; // the kmer sketch graph
     // VCF vcf;
@@ -51,6 +102,12 @@ public:
 
     LocalPRG(uint32_t id, const std::string& name, const std::string& seq);
 
+    // frees seq once the graph is built: sequences along paths are then decoded from
+    // the packed sequences of the local nodes
+    void release_seq();
+
+    uint32_t get_seq_length() const { return seq_length; }
+
     // functions used to create LocalGraph from PRG string, and to sketch graph
     bool isalpha_string(const std::string&) const;
 
@@ -70,6 +127,12 @@ public:
     void minimizer_sketch(const std::shared_ptr<Index>& index, const uint32_t w,
         const uint32_t k, double percentageDone = -1.0);
 
+    // sketches the graph with the open syncmers of s-mers of s bases (see syncmer.h)
+    // instead of (w,k)-minimizers. Paths of the PRG without any syncmer are given their
+    // last k-mer, so that the k-mer graph stays connected
+    void syncmer_sketch(const std::shared_ptr<Index>& index, const uint32_t k,
+        const uint32_t s, double percentageDone = -1.0);
+
     // functions used once hits have been collected against the PRG
     std::vector<KmerNodePtr> kmernode_path_from_localnode_path(
         const std::vector<LocalNodePtr>&) const;
@@ -105,6 +168,19 @@ public:
     void build_vcf_from_reference_path(
         VCF& vcf, const std::vector<LocalNodePtr>& ref) const;
 
+    // the variant sites along the reference path ref, in the order their records are
+    // added to the VCF by build_vcf_from_reference_path()
+    std::vector<VCFSite> get_vcf_sites(const std::vector<LocalNodePtr>& ref) const;
+
+    // saves the VCF sites of the reference path ref, so that later runs can reuse them
+    // instead of walking the graph again
+    void save_vcf_sites(
+        const fs::path& filepath, const std::vector<LocalNodePtr>& ref) const;
+
+    // file of the VCF sites saved by save_vcf_sites(), if any. They are read by
+    // build_vcf_from_reference_path() when given the same reference path, and not kept
+    fs::path vcf_sites_file;
+
     virtual std::pair<std::vector<uint32_t>, std::vector<uint32_t>>
     get_forward_and_reverse_kmer_coverages_in_range(
         const KmerGraphWithCoverage& kmer_graph_with_coverage,
@@ -125,11 +201,26 @@ public:
         const std::vector<LocalNodePtr>& ref_path, const std::string& sample_name,
         const uint32_t& sample_id) const;
 
+    // sets the coverages of the sample at sample_index on the given records of a VCF
+    // built from ref_path (ref_kmer_path being its kmer path). Only the sample info of
+    // this sample is touched, so different samples can be processed concurrently
+    void add_sample_covgs_to_vcf_records(const std::vector<VCFRecord*>& records,
+        const KmerGraphWithCoverage& kg, const std::vector<LocalNodePtr>& ref_path,
+        const std::vector<KmerNodePtr>& ref_kmer_path, const size_t sample_index,
+        const uint32_t& sample_id) const;
+
     void add_consensus_path_to_fastaq(Fastaq&, PanNodePtr, std::vector<KmerNodePtr>&,
         std::vector<LocalNodePtr>&, const uint32_t, const bool, const uint32_t,
         const uint32_t& max_num_kmers_to_average, const uint32_t& sample_id) const;
     std::vector<LocalNodePtr> get_valid_vcf_reference(const std::string&) const;
 
+    // builds in the given VCF the variants of this locus for the sample, with their
+    // coverages. The records only refer to this locus, so they can be genotyped on
+    // their own
+    void build_sample_vcf(VCF&, PanNodePtr, const std::string&,
+        const std::vector<KmerNodePtr>&, const std::vector<LocalNodePtr>&,
+        const uint32_t& sample_id = 0, const std::string& sample_name = "sample");
+
     void add_variants_to_vcf(VCF&, PanNodePtr, const std::string&,
         const std::vector<KmerNodePtr>&, const std::vector<LocalNodePtr>&,
         const uint32_t& sample_id = 0, const std::string& sample_name = "sample");
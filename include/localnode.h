@@ -10,6 +10,7 @@
 #include "interval.h"
 #include "prg/path.h"
 #include "kmernode.h"
+#include "packed_sequence.h"
 
 class LocalNode;
 
@@ -19,7 +20,7 @@ class LocalNode {
     std::unordered_set<KmerNodePtr> prev_kmer_paths;
 
 public:
-    std::string seq;
+    PackedSequence seq; // 2-bit packed, decode with seq.to_string()
     Interval pos; // pos in the prg
     uint32_t id;
     uint32_t covg; // covg by hits - initially has the size of the interval
@@ -30,12 +30,14 @@ namespace fs = boost::filesystem;
 /// Collection of all options of map subcommand.
 struct MapOptions {
     fs::path prgfile;
-    fs::path readsfile;
+    std::vector<fs::path> readsfiles;
     fs::path outdir { "pandora" };
     uint32_t window_size { 14 };
     uint32_t kmer_size { 15 };
+    uint32_t query_window_size { 0 };
     uint32_t threads { 1 };
     fs::path vcf_refs_file;
+    fs::path loci_file;
     uint8_t verbosity { 0 };
     float error_rate { 0.11 };
     uint32_t genome_size { 5000000 };
@@ -46,8 +48,11 @@ struct MapOptions {
     bool output_mapped_read_fa { false };
     bool illumina { false };
     bool clean { false };
+    bool clean_by_component { false };
     bool binomial { false };
     uint32_t max_covg { 300 };
+    float subsample_fraction { 1 };
+    uint32_t target_covg { 0 };
     bool genotype { false };
     bool local_genotype { false };
     bool snps_only { false };
@@ -4,6 +4,9 @@
 
 #include <string>
 #include <cstdint>
+#include <memory>
+#include <vector>
+#include <unordered_map>
 #include "pangenome/pangraph.h"
 #include "de_bruijn/graph.h"
 
@@ -39,8 +42,27 @@ void filter_unitigs(
 void detangle_pangraph_with_debruijn_graph(
     std::shared_ptr<pangenome::Graph>, debruijn::Graph&);
 
+// the reads and nodes of a pangraph split by connected component, i.e. sets of nodes
+// linked by reads, which can be cleaned independently of each other
+struct PangraphComponents {
+    std::vector<std::shared_ptr<pangenome::Graph>> graphs;
+    std::unordered_map<NodeId, uint32_t> node_id_to_component;
+    std::unordered_map<ReadId, uint32_t> read_id_to_component;
+};
+
+PangraphComponents split_pangraph_into_components(
+    const std::shared_ptr<pangenome::Graph>&);
+
+void merge_pangraph_components(
+    std::shared_ptr<pangenome::Graph>, const PangraphComponents&);
+
+// if clean_by_component, the connected components of the pangraph are cleaned on their
+// own, in parallel with the given number of threads. The nodes created when detangling
+// are then numbered component after component, so their ids can differ from those of
+// the serial cleaning, which interleaves the components
 void clean_pangraph_with_debruijn_graph(std::shared_ptr<pangenome::Graph>,
-    const uint_least32_t, const uint_least32_t, const bool illumina = false);
+    const uint_least32_t, const uint_least32_t, const bool illumina = false,
+    const bool clean_by_component = false, const uint32_t threads = 1);
 
 void write_pangraph_gfa(
     const fs::path& filepath, std::shared_ptr<pangenome::Graph> pangraph);
@@ -0,0 +1,49 @@
+#ifndef __PACKED_SEQUENCE_H_INCLUDED__
+#define __PACKED_SEQUENCE_H_INCLUDED__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+
+/**
+ * A sequence stored with 2 bits per base (A=0, C=1, G=2, T=3), 32 bases per word.
+ * Characters that are not an upper-case ACGT (e.g. N or lower-case bases) are kept in
+ * an exception list by position, so that decoding gives back exactly the original
+ * string.
+ */
+class PackedSequence {
+private:
+    uint32_t number_of_bases;
+    std::vector<uint64_t> packed_bases;
+    std::vector<std::pair<uint32_t, char>> exceptions; // sorted by position
+
+public:
+    PackedSequence(const std::string& sequence = "");
+
+    uint32_t length() const { return number_of_bases; }
+
+    uint32_t size() const { return number_of_bases; }
+
+    bool empty() const { return number_of_bases == 0; }
+
+    char at(const uint32_t position) const;
+
+    // appends length bases from start (or up to the end of the sequence) to s
+    void append_to(
+        std::string& s, const uint32_t start = 0, uint32_t length = UINT32_MAX) const;
+
+    std::string substr(
+        const uint32_t start = 0, const uint32_t length = UINT32_MAX) const;
+
+    std::string to_string() const;
+
+    bool operator==(const PackedSequence& other) const;
+
+    bool operator!=(const PackedSequence& other) const;
+
+    friend std::ostream& operator<<(std::ostream& out, const PackedSequence& sequence);
+};
+
+#endif
@@ -137,6 +137,12 @@ public:
     void split_node_by_reads(std::unordered_set<ReadPtr>&, std::vector<uint_least32_t>&,
         const std::vector<bool>&, const uint_least32_t);
 
+    /**
+     * Gets the smallest node id not used by a node of this graph, from the last one
+     * given onwards. Used to give an id to the nodes created when splitting nodes.
+     */
+    uint32_t get_next_free_node_id();
+
     void add_hits_to_kmergraphs(const uint32_t& sample_id = 0);
 
     void copy_coverages_to_kmergraphs(const Graph&, const uint32_t&);
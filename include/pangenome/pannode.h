@@ -50,11 +50,30 @@ public:
 
     void add_path(const std::vector<KmerNodePtr>&, const uint32_t& sample_id);
 
+    // a minimizer hit of a read on this node, keyed by the start of its PRG path
+    struct ReadHit {
+        uint32_t prg_start;
+        uint32_t read_id;
+        uint32_t read_position;
+        uint32_t hit_index; // order of the hit among the hits of its read
+        bool is_forward;
+        const prg::Path* prg_path;
+    };
+    // the hits of all reads on this node, sorted by the start of their PRG path
+    using ReadHitTable = std::vector<ReadHit>;
+
     void get_read_overlap_coordinates(std::vector<std::vector<uint32_t>>&);
 
+    ReadHitTable build_read_hit_table() const;
+
     std::set<ReadCoordinate> get_read_overlap_coordinates(
         const prg::Path& local_path, const uint32_t& min_number_hits = 2);
 
+    // same as above, but only looks up the hits of the table starting inside the
+    // local path, so that one table can be reused for all regions of this node
+    std::set<ReadCoordinate> get_read_overlap_coordinates(const prg::Path& local_path,
+        const ReadHitTable& read_hit_table, const uint32_t& min_number_hits = 2) const;
+
     void construct_multisample_vcf(VCF& master_vcf,
         const std::vector<LocalNodePtr>& vcf_reference_path,
         const std::shared_ptr<LocalPRG>& prg, const uint32_t w);
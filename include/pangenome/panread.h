@@ -17,6 +17,17 @@ private:
     std::vector<MinimizerHit*> hits; // store all Minimizer Hits mapping to this read
     std::vector<WeakNodePtr> nodes;
 
+    // positions of each node id along nodes, built lazily by find_position and
+    // invalidated when nodes are added or removed
+    std::unordered_map<uint32_t, std::vector<uint32_t>> node_id_to_positions;
+    bool node_id_to_positions_is_valid = false;
+
+    const std::vector<uint32_t>& get_positions_of_node_id(uint32_t node_id);
+
+    // positions i of nodes where find_position can find a match, in increasing order
+    std::vector<uint32_t> get_candidate_positions(
+        uint32_t first_node_id, uint32_t number_of_node_ids);
+
 public:
     const uint32_t id; // read id
     std::vector<bool> node_orientations;
@@ -35,10 +46,16 @@ public:
     // TODO: this getter allows the caller to the private attribute nodes, use with
     // care...
     // TODO: replace/remove this?
+    // NB: nodes should only be added/removed through the modifiers below, which keep
+    // the node positions used by find_position up to date
     std::vector<WeakNodePtr>& get_nodes() { return nodes; }
 
     // TODO: just used in tests, move to private and friend the test class
-    void set_nodes(const std::vector<WeakNodePtr>& nodes) { this->nodes = nodes; }
+    void set_nodes(const std::vector<WeakNodePtr>& nodes)
+    {
+        this->nodes = nodes;
+        node_id_to_positions_is_valid = false;
+    }
 
     std::vector<WeakNodePtr>::iterator find_node_by_id(uint32_t node_id);
 
@@ -47,6 +64,7 @@ public:
     {
         nodes.push_back(nodePtr);
         nodes.shrink_to_fit();
+        node_id_to_positions_is_valid = false;
     }
     void add_orientation(bool orientation)
     {
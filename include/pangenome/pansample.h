@@ -8,16 +8,45 @@
 #include "pangenome/ns.cpp"
 
 class KmerNode;
+class KmerGraph;
 
 typedef std::shared_ptr<KmerNode> KmerNodePtr;
 
+/**
+ * A k-mer path of a sample through a node, stored as the ids of its k-mer nodes.
+ * Ids are mostly increasing along a path, so each id is stored as a zigzag varint of
+ * its difference to the previous one, which takes one or two bytes per k-mer node
+ * instead of a shared_ptr.
+ */
+class pangenome::SamplePath {
+private:
+    std::vector<uint8_t> encoded_node_ids;
+    uint32_t number_of_nodes;
+
+public:
+    explicit SamplePath(const std::vector<KmerNodePtr>& kmer_path);
+
+    size_t size() const { return number_of_nodes; }
+
+    bool empty() const { return number_of_nodes == 0; }
+
+    std::vector<uint32_t> get_node_ids() const;
+
+    // resolves the ids to the nodes of the k-mer graph the path was built on
+    std::vector<KmerNodePtr> get_kmer_path(const KmerGraph& kmer_graph) const;
+
+    bool operator==(const SamplePath& other) const;
+
+    bool operator!=(const SamplePath& other) const;
+};
+
 class pangenome::Sample {
 public:
     const std::string name; // first column in index of read files
     const uint32_t sample_id;
     std::vector<WeakNodePtr> nodes;
     std::vector<bool> node_orientations;
-    std::unordered_map<uint32_t, std::vector<std::vector<KmerNodePtr>>>
+    std::unordered_map<uint32_t, std::vector<SamplePath>>
         paths; // from prg id (or unique id) to kmernnode path(s) through each node
 
     Sample(const std::string&, const uint32_t& id);
@@ -214,6 +214,13 @@ public:
 
 bool equal_except_null_nodes(const prg::Path&, const prg::Path&);
 
+namespace std {
+// hashes the interval sequence of a path, consistently with prg::Path::operator==
+template <> struct hash<prg::Path> {
+    size_t operator()(const prg::Path& path) const;
+};
+}
+
 typedef std::shared_ptr<prg::Path> PathPtr;
 struct ComparePathPtr {
     bool operator()(const PathPtr& p1, const PathPtr& p2) const
@@ -4,7 +4,9 @@
 #include <string>
 #include <cstdint>
 #include <set>
+#include <vector>
 #include <ostream>
+#include <boost/utility/string_ref.hpp>
 #include "minimizer.h"
 
 class Seq {
@@ -14,15 +16,17 @@ public:
     std::string seq;
     std::set<Minimizer> sketch;
 
-    Seq(uint32_t, const std::string&, const std::string&, uint32_t, uint32_t);
+    // reads are sketched with (w,k)-minimizers, or with open syncmers of s-mers of
+    // syncmer_size bases if it is not 0
+    Seq(uint32_t, const std::string&, const std::string&, uint32_t, uint32_t,
+        uint32_t syncmer_size = 0);
 
     ~Seq();
 
-    void initialize(
-        uint32_t, const std::string&, const std::string&, uint32_t, uint32_t);
-
-    bool add_letter_to_get_next_kmer(const char&, const uint64_t&, const uint64_t&,
-        uint32_t&, uint64_t (&)[2], uint64_t (&)[2]);
+    // reuses the name and sequence buffers, so that a Seq can be recycled across
+    // reads without reallocating
+    void initialize(uint32_t, boost::string_ref, boost::string_ref, uint32_t, uint32_t,
+        uint32_t syncmer_size = 0);
 
     void add_minimizing_kmers_to_sketch(const std::vector<Minimizer>&, const uint64_t&);
 
@@ -32,7 +36,18 @@ public:
 
     void minimizer_sketch(const uint32_t w, const uint32_t k);
 
+    void syncmer_sketch(const uint32_t k, const uint32_t s);
+
     friend std::ostream& operator<<(std::ostream& out, const Seq& data);
+
+private:
+    // hashes of the forward k-mers (and s-mers, for syncmers) of seq followed by the
+    // hashes of their reverse complements, reused across the reads sketched with this
+    // Seq
+    std::vector<uint64_t> kmer_hashes;
+    std::vector<uint64_t> smer_hashes;
+
+    bool hash_kmers_of_sequence(const uint32_t k, std::vector<uint64_t>& hashes);
 };
 
 #endif
@@ -0,0 +1,27 @@
+#ifndef __SYNCMER_H_INCLUDED__ // if syncmer.h hasn't been included yet...
+#define __SYNCMER_H_INCLUDED__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "inthash.h"
+
+/**
+ * An open syncmer is a k-mer whose smallest s-mer, read along the strand of its
+ * canonical k-mer, is its first s-mer. Unlike a minimizer, whether a k-mer is a
+ * syncmer only depends on the k-mer itself (not on a window of k-mers around it), and
+ * does not depend on the strand it is read from. The expected density of a syncmer
+ * sketch is 1/(k-s+1).
+ *
+ * smer_hashes are the hashes of the k-s+1 s-mers of the k-mer, in the order of the
+ * forward k-mer. They are the hashes of the forward s-mers if the forward k-mer is
+ * canonical, and of their reverse complements otherwise.
+ */
+bool is_open_syncmer(const uint64_t* smer_hashes, const uint32_t number_of_smers,
+    const bool forward_is_canonical);
+
+// same as above, hashing the s-mers of the k-mer with hash
+bool is_open_syncmer(const std::string& kmer, const uint32_t s,
+    const bool forward_is_canonical, KmerHash& hash);
+
+#endif
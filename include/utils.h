@@ -5,10 +5,12 @@
 #include <set>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <cstdint>
 #include <string>
 #include <limits>
 #include <boost/filesystem/path.hpp>
+#include <boost/utility/string_ref.hpp>
 #include "minihits.h"
 #include "pangenome/ns.cpp"
 #include <boost/log/trivial.hpp>
@@ -68,19 +70,83 @@ std::string rev_complement(std::string);
 float lognchoosek2(uint32_t, uint32_t, uint32_t);
 
 // probably should be moved to map_main.cpp
+// if loci_to_load is not empty, only the PRGs with these names are built, and the other
+// PRGs are left as nullptr, so that prgs is still indexed by PRG id
+// if release_seqs is true, the PRG strings are freed once their graphs are built
 void read_prg_file(std::vector<std::shared_ptr<LocalPRG>>& prgs,
-    const fs::path& filepath, uint32_t id = 0);
+    const fs::path& filepath, uint32_t id = 0,
+    const std::unordered_set<std::string>& loci_to_load = {},
+    const bool release_seqs = false);
+
+// A slice of the PRGs of a file, by their position in the file (records without a name
+// or a sequence are not counted, as in read_prg_file): either the positions
+// [start, end), or the shard_number-th (1-based) of number_of_shards consecutive
+// slices of about the same size
+struct PrgSlice {
+    uint32_t start { 0 };
+    uint32_t end { std::numeric_limits<uint32_t>::max() };
+    uint32_t shard_number { 0 };
+    uint32_t number_of_shards { 0 }; // 0 if the slice is given by start and end
+
+    // parses a slice given as START-END or I/N
+    static PrgSlice from_string(const std::string& slice);
+
+    bool is_shard() const { return number_of_shards > 0; }
+
+    // the positions [first, second) of this slice in a file of number_of_prgs PRGs
+    std::pair<uint32_t, uint32_t> get_range(const uint32_t number_of_prgs) const;
+};
 
+// Offsets of the PRG records of an uncompressed PRG file. They are read from the sidecar
+// file <PRG>.offsets if it is newer than the PRG file and was made from a file of the
+// same size, unless use_saved_offsets is false. Otherwise they are found by skimming
+// the records, without building the PRGs, and saved to the sidecar file.
+std::vector<uint64_t> get_prg_record_offsets(
+    const fs::path& prgfile, const bool use_saved_offsets = true);
+
+// Builds only the PRGs of the given slice of the file, the PRG at position i having id
+// id + i. Uncompressed files are seeked to the first PRG of the slice using the record
+// offsets; gzipped files are streamed, the records before the slice being skipped
+// without building them. Returns the position of the first PRG of the slice.
+uint32_t read_prg_file_slice(std::vector<std::shared_ptr<LocalPRG>>& prgs,
+    const fs::path& filepath, const PrgSlice& slice, uint32_t id = 0);
+
+// loads the kmer graphs of the PRGs in prgs, skipping the ones not loaded (nullptr)
 void load_PRG_kmergraphs(std::vector<std::shared_ptr<LocalPRG>>& prgs,
     const uint32_t& w, const uint32_t& k, const fs::path& prgfile);
 
+// loads a file with a locus name per line
+std::unordered_set<std::string> load_loci_file(const fs::path& loci_filepath);
+
+// returns the ids of the PRGs that were loaded in prgs (i.e. that are not nullptr)
+std::unordered_set<uint32_t> get_loaded_prg_ids(
+    const std::vector<std::shared_ptr<LocalPRG>>& prgs);
+
 void load_vcf_refs_file(const fs::path& filepath, VCFRefs& vcf_refs);
 
 void add_read_hits(const Seq&, const std::shared_ptr<MinimizerHits>&, const Index&);
 
+// the number of hits a cluster on this PRG must exceed to be kept
+uint32_t get_cluster_size_threshold(const std::shared_ptr<LocalPRG>& prg,
+    const uint32_t min_cluster_size,
+    const uint32_t expected_number_kmers_in_read_sketch,
+    const float& fraction_kmers_required_for_cluster,
+    const float query_sketch_density_ratio = 1);
+
+// adds the hits of the read, except those of the (PRG, strand) pairs of the read that
+// have too few hits to ever form a cluster, and returns the number of hits before this
+// filtering
+uint64_t add_read_hits(const Seq& sequence,
+    const std::shared_ptr<MinimizerHits>& minimizer_hits, const Index& index,
+    const std::vector<std::shared_ptr<LocalPRG>>& prgs, const uint32_t min_cluster_size,
+    const uint32_t expected_number_kmers_in_read_sketch,
+    const float& fraction_kmers_required_for_cluster,
+    const float query_sketch_density_ratio = 1);
+
 void define_clusters(std::set<std::set<MinimizerHitPtr, pComp>, clusterComp>&,
     const std::vector<std::shared_ptr<LocalPRG>>&, std::shared_ptr<MinimizerHits>,
-    const int, const float&, const uint32_t, const uint32_t);
+    const int, const float&, const uint32_t, const uint32_t,
+    const float query_sketch_density_ratio = 1);
 
 void filter_clusters(std::set<std::set<MinimizerHitPtr, pComp>, clusterComp>&);
 
@@ -91,14 +157,31 @@ void infer_localPRG_order_for_reads(const std::vector<std::shared_ptr<LocalPRG>>
     std::shared_ptr<MinimizerHits> minimizer_hits, std::shared_ptr<pangenome::Graph>,
     const int, const uint32_t&, const float&, const uint32_t min_cluster_size = 10,
     const uint32_t expected_number_kmers_in_short_read_sketch
-    = std::numeric_limits<uint32_t>::max());
+    = std::numeric_limits<uint32_t>::max(),
+    const float query_sketch_density_ratio = 1);
+
+// ratio between the density of a read sketch using a window query_w >= w and the
+// density of the index sketch, i.e. (w+1)/(query_w+1)
+float get_query_sketch_density_ratio(const uint32_t w, const uint32_t query_w);
+
+// expected number of k-mers in the sketch of a read: 2/(query_w+1) of its bases with
+// (query_w,k)-minimizers, or 1/(k-s+1) with open syncmers of s-mer size s > 0
+uint32_t get_expected_number_kmers_in_read_sketch(const uint32_t read_length,
+    const uint32_t query_w, const uint32_t k, const uint32_t syncmer_size);
 
 uint32_t pangraph_from_read_file(const std::string&, std::shared_ptr<pangenome::Graph>,
     std::shared_ptr<Index>, const std::vector<std::shared_ptr<LocalPRG>>&,
     const uint32_t, const uint32_t, const int, const float&,
     const uint32_t min_cluster_size = 10, const uint32_t genome_size = 5000000,
     const bool illumina = false, const bool clean = false,
-    const uint32_t max_covg = 300, uint32_t threads = 1);
+    const uint32_t max_covg = 300, uint32_t threads = 1, uint32_t query_w = 0,
+    const float subsample_fraction = 1, const uint32_t target_covg = 0,
+    const bool clean_by_component = false);
+
+// deterministically decides if a read is kept when subsampling a fraction of the reads,
+// based on a hash of its name
+bool read_is_kept_when_subsampling(
+    boost::string_ref read_name, const float subsample_fraction);
 
 void infer_most_likely_prg_path_for_pannode(
     const std::vector<std::shared_ptr<LocalPRG>>&, PanNode*, uint32_t, float);
@@ -123,8 +206,13 @@ std::string transform_cli_gsize(std::string);
 std::string make_absolute(std::string);
 
 using SampleIdText = std::string;
+// path to the reads of a sample - several read files are separated by commas
 using SampleFpath = std::string;
 
+// joins read files into a single comma-separated SampleFpath, which FastaqHandler
+// streams one file after the other
+SampleFpath join_read_filepaths(const std::vector<fs::path>& read_filepaths);
+
 std::vector<std::pair<SampleIdText, SampleFpath>> load_read_index(
     const fs::path& read_index_fpath);
 
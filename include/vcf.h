@@ -100,6 +100,12 @@ public:
     }
     virtual VCF correct_dot_alleles(
         const std::string& vcf_ref, const std::string& chrom) const;
+
+    // in-place versions of merge_multi_allelic() and correct_dot_alleles(): records
+    // are moved instead of copied, and nothing is rebuilt if no record qualifies
+    virtual void merge_multi_allelic_in_place(uint32_t max_allele_length = 100000);
+    virtual void correct_dot_alleles_in_place(
+        const std::string& vcf_ref, const std::string& chrom);
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -117,6 +123,7 @@ public:
     // misc methods
     virtual void
     sort_records(); // TODO: remove this method and store the records always sorted
+    virtual void sort_records_if_unsorted();
     virtual bool pos_in_range(const uint32_t, const uint32_t, const std::string&) const;
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -149,6 +156,9 @@ protected:
     // add a VCF record to this VCF
     virtual void add_record_core(const VCFRecord& vr);
 
+    // rebuild chrom_to_record_interval_tree from records
+    virtual void rebuild_record_interval_trees();
+
     // find a VCRRecord in records
     virtual inline std::vector<std::shared_ptr<VCFRecord>>::iterator
     find_record_in_records(const VCFRecord& vr);
@@ -17,7 +17,9 @@ void setup_compare_subcommand(CLI::App& app)
 
     std::string description
         = "A tab-delimited file where each line is a sample identifier followed by "
-          "the path to the fast{a,q} of reads for that sample";
+          "the path to the fast{a,q} of reads for that sample. Several read files "
+          "for a sample can be given as a comma-separated list, unless a file name "
+          "contains a comma";
     compare_subcmd->add_option("<QUERY_IDX>", opt->reads_idx_file, description)
         ->required()
         ->transform(make_absolute)
@@ -36,6 +38,13 @@ void setup_compare_subcommand(CLI::App& app)
         ->capture_default_str()
         ->group("Indexing");
 
+    compare_subcmd
+        ->add_option("--query-window", opt->query_window_size,
+            "Window size used to sketch reads (must be >=w). Larger values give a "
+            "sparser read sketch: faster mapping, lower sensitivity [default: w]")
+        ->type_name("INT")
+        ->group("Mapping");
+
     compare_subcmd
         ->add_option("-o,--outdir", opt->outdir, "Directory to write output files to")
         ->type_name("DIR")
@@ -57,6 +66,14 @@ void setup_compare_subcommand(CLI::App& app)
         ->check(CLI::ExistingFile.description(""))
         ->group("Input/Output");
 
+    description = "File with the names of the loci to restrict to, one per line. Only "
+                  "these loci are loaded from <TARGET> and searched for in the reads";
+    compare_subcmd->add_option("--loci", opt->loci_file, description)
+        ->type_name("FILE")
+        ->transform(make_absolute)
+        ->check(CLI::ExistingFile.description(""))
+        ->group("Input/Output");
+
     compare_subcmd
         ->add_option(
             "-e,--error-rate", opt->error_rate, "Estimated error rate for reads")
@@ -89,9 +106,15 @@ void setup_compare_subcommand(CLI::App& app)
             "reads")
         ->group("Preset");
 
+    description = "Add a step to clean and detangle the pangraph";
+    auto* clean_opt = compare_subcmd->add_flag("--clean", opt->clean, description)
+                          ->group("Filtering");
+
     compare_subcmd
-        ->add_flag(
-            "--clean", opt->clean, "Add a step to clean and detangle the pangraph")
+        ->add_flag("--clean-by-component", opt->clean_by_component,
+            "Clean the connected components of the pangraph separately, in parallel. "
+            "Nodes created when detangling are then numbered component by component")
+        ->needs(clean_opt)
         ->group("Filtering");
 
     compare_subcmd
@@ -222,12 +245,24 @@ int pandora_compare(CompareOptions& opt)
         opt.min_allele_fraction_covg_gt, opt.min_total_covg_gt, opt.min_diff_covg_gt, 0,
         false);
 
+    std::unordered_set<std::string> loci_to_load;
+    if (!opt.loci_file.empty()) {
+        loci_to_load = load_loci_file(opt.loci_file);
+    }
+
     BOOST_LOG_TRIVIAL(info) << "Loading Index and LocalPRGs from file...";
-    auto index = std::make_shared<Index>();
-    index->load(opt.prgfile, opt.window_size, opt.kmer_size);
     std::vector<std::shared_ptr<LocalPRG>> prgs;
-    read_prg_file(prgs, opt.prgfile);
+    read_prg_file(prgs, opt.prgfile, 0, loci_to_load, true);
     load_PRG_kmergraphs(prgs, opt.window_size, opt.kmer_size, opt.prgfile);
+    std::unordered_set<uint32_t> prg_ids_to_load;
+    if (!loci_to_load.empty()) {
+        prg_ids_to_load = get_loaded_prg_ids(prgs);
+        if (prg_ids_to_load.empty()) {
+            fatal_error("None of the loci in ", opt.loci_file, " are in ", opt.prgfile);
+        }
+    }
+    auto index = std::make_shared<Index>();
+    index->load(opt.prgfile, opt.window_size, opt.kmer_size, prg_ids_to_load);
 
     BOOST_LOG_TRIVIAL(info) << "Loading read index file...";
     auto samples = load_read_index(opt.reads_idx_file);
@@ -255,7 +290,8 @@ int pandora_compare(CompareOptions& opt)
         uint32_t covg = pangraph_from_read_file(sample_fpath, pangraph_sample, index,
             prgs, opt.window_size, opt.kmer_size, opt.max_diff, opt.error_rate,
             opt.min_cluster_size, opt.genome_size, opt.illumina, opt.clean,
-            opt.max_covg, opt.threads);
+            opt.max_covg, opt.threads, opt.query_window_size, 1, 0,
+            opt.clean_by_component);
 
         const auto pangraph_gfa { sample_outdir / "pandora.pangraph.gfa" };
         BOOST_LOG_TRIVIAL(info) << "Writing pangenome::Graph to file " << pangraph_gfa;
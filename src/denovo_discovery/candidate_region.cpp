@@ -145,6 +145,11 @@ CandidateRegions Discover::find_candidate_regions_for_pan_node(
                              << " candidate intervals after merging";
 
     CandidateRegions candidate_regions;
+    if (candidate_intervals.empty()) {
+        return candidate_regions;
+    }
+
+    const auto read_hit_table { pangraph_node->build_read_hit_table() };
 
     for (const auto& current_interval : candidate_intervals) {
         CandidateRegion candidate_region { current_interval, pangraph_node->get_name(),
@@ -155,7 +160,7 @@ CandidateRegions Discover::find_candidate_regions_for_pan_node(
             candidate_region.get_interval(), local_node_max_likelihood_path) };
 
         candidate_region.read_coordinates = pangraph_node->get_read_overlap_coordinates(
-            interval_path_components.slice);
+            interval_path_components.slice, read_hit_table);
 
         BOOST_LOG_TRIVIAL(trace)
             << "Candidate region with interval " << candidate_region.get_interval()
@@ -229,6 +234,18 @@ void CandidateRegion::add_pileup_entry(
     }
 }
 
+uint64_t CandidateRegion::get_estimated_pileup_memory() const
+{
+    uint64_t estimated_pileup_memory = 0;
+    for (const auto& read_coordinate : read_coordinates) {
+        estimated_pileup_memory
+            += sizeof(std::string) + read_coordinate.end - read_coordinate.start;
+    }
+    return estimated_pileup_memory;
+}
+
+void CandidateRegion::release_pileup() { ReadPileup().swap(pileup); }
+
 void CandidateRegion::write_denovo_paths_to_buffer(CandidateRegionWriteBuffer& buffer)
 {
     if (denovo_paths.empty()) {
@@ -315,17 +332,61 @@ TmpPanNode::TmpPanNode(const PanNodePtr& pangraph_node,
 PileupConstructionMap Discover::pileup_construction_map(
     CandidateRegions& candidate_regions)
 {
-    PileupConstructionMap pileup_construction_map;
+    std::vector<CandidateRegion*> candidate_regions_as_vector;
+    candidate_regions_as_vector.reserve(candidate_regions.size());
     for (auto& element : candidate_regions) {
-        auto& candidate_region { element.second };
-        for (const auto& read_coordinate : candidate_region.read_coordinates) {
+        candidate_regions_as_vector.push_back(&element.second);
+    }
+    return pileup_construction_map(candidate_regions_as_vector);
+}
+
+PileupConstructionMap Discover::pileup_construction_map(
+    const std::vector<CandidateRegion*>& candidate_regions)
+{
+    PileupConstructionMap pileup_construction_map;
+    for (CandidateRegion* candidate_region : candidate_regions) {
+        for (const auto& read_coordinate : candidate_region->read_coordinates) {
             pileup_construction_map[read_coordinate.id].emplace_back(
-                &candidate_region, &read_coordinate);
+                candidate_region, &read_coordinate);
         }
     }
     return pileup_construction_map;
 }
 
+void Discover::sort_candidate_regions_by_decreasing_cost(
+    std::vector<CandidateRegion*>& candidate_regions)
+{
+    // the cost of assembling a region grows with its pileup and its length
+    const auto estimated_cost = [](const CandidateRegion* candidate_region) {
+        return (uint64_t)candidate_region->pileup.size()
+            * candidate_region->get_interval().length;
+    };
+    std::stable_sort(candidate_regions.begin(), candidate_regions.end(),
+        [&estimated_cost](const CandidateRegion* lhs, const CandidateRegion* rhs) {
+            return estimated_cost(lhs) > estimated_cost(rhs);
+        });
+}
+
+std::vector<std::vector<CandidateRegion*>> Discover::get_candidate_region_waves(
+    CandidateRegions& candidate_regions, const uint64_t max_pileup_memory)
+{
+    std::vector<std::vector<CandidateRegion*>> waves;
+    uint64_t wave_pileup_memory = 0;
+    for (auto& element : candidate_regions) {
+        CandidateRegion* candidate_region = &element.second;
+        const uint64_t pileup_memory = candidate_region->get_estimated_pileup_memory();
+        const bool wave_is_full = max_pileup_memory > 0
+            and wave_pileup_memory + pileup_memory > max_pileup_memory;
+        if (waves.empty() or wave_is_full) {
+            waves.emplace_back();
+            wave_pileup_memory = 0;
+        }
+        waves.back().push_back(candidate_region);
+        wave_pileup_memory += pileup_memory;
+    }
+    return waves;
+}
+
 void Discover::load_candidate_region_pileups(const fs::path& reads_filepath,
     const CandidateRegions& candidate_regions,
     const PileupConstructionMap& pileup_construction_map, uint32_t threads)
@@ -356,11 +417,18 @@ void Discover::load_candidate_region_pileups(const fs::path& reads_filepath,
                 // TODO: we need to read only until the max read id
                 for (auto& id_and_sequence : sequencesBuffer) {
                     try {
-                        fh.get_next();
+                        fh.get_next_view();
                     } catch (std::out_of_range& err) {
                         break;
                     }
-                    id_and_sequence = make_pair(id, fh.read);
+                    // only the reads used in a pileup are copied
+                    id_and_sequence.first = id;
+                    if (pileup_construction_map.count(id)) {
+                        id_and_sequence.second.assign(
+                            fh.read_view.data(), fh.read_view.size());
+                    } else {
+                        id_and_sequence.second.clear();
+                    }
                     ++nbOfReads;
                     ++id;
                 }
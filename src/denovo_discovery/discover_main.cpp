@@ -3,6 +3,8 @@
 //
 
 #include "denovo_discovery/discover_main.h"
+#include <atomic>
+#include <sys/mman.h>
 
 void setup_discover_subcommand(CLI::App& app)
 {
@@ -20,7 +22,9 @@ void setup_discover_subcommand(CLI::App& app)
 
     std::string description
         = "A tab-delimited file where each line is a sample identifier followed by "
-          "the path to the fast{a,q} of reads for that sample";
+          "the path to the fast{a,q} of reads for that sample. Several read files "
+          "for a sample can be given as a comma-separated list, unless a file name "
+          "contains a comma";
     discover_subcmd->add_option("<QUERY_IDX>", opt->reads_idx_file, description)
         ->required()
         ->transform(make_absolute)
@@ -39,6 +43,13 @@ void setup_discover_subcommand(CLI::App& app)
         ->capture_default_str()
         ->group("Indexing");
 
+    discover_subcmd
+        ->add_option("--query-window", opt->query_window_size,
+            "Window size used to sketch reads (must be >=w). Larger values give a "
+            "sparser read sketch: faster mapping, lower sensitivity [default: w]")
+        ->type_name("INT")
+        ->group("Mapping");
+
     discover_subcmd
         ->add_option("-o,--outdir", opt->outdir, "Directory to write output files to")
         ->transform(make_absolute)
@@ -91,9 +102,15 @@ void setup_discover_subcommand(CLI::App& app)
             "reads")
         ->group("Preset");
 
+    description = "Add a step to clean and detangle the pangraph";
+    auto* clean_opt = discover_subcmd->add_flag("--clean", opt->clean, description)
+                          ->group("Filtering");
+
     discover_subcmd
-        ->add_flag(
-            "--clean", opt->clean, "Add a step to clean and detangle the pangraph")
+        ->add_flag("--clean-by-component", opt->clean_by_component,
+            "Clean the connected components of the pangraph separately, in parallel. "
+            "Nodes created when detangling are then numbered component by component")
+        ->needs(clean_opt)
         ->group("Filtering");
 
     discover_subcmd
@@ -163,6 +180,14 @@ void setup_discover_subcommand(CLI::App& app)
         ->capture_default_str()
         ->type_name("INT");
 
+    description = "Maximum memory (in MB) of the read pileups of the candidate regions "
+                  "assembled at once. Regions are assembled in waves within this "
+                  "limit, reading the reads once per wave (0 for no limit)";
+    discover_subcmd
+        ->add_option("--max-pileup-mem", opt->max_pileup_memory, description)
+        ->capture_default_str()
+        ->type_name("INT");
+
     description
         = "Minimum size of a cluster of hits between a read and a loci to consider "
           "the loci present";
@@ -206,16 +231,19 @@ void concatenate_denovo_files(
 
 void find_denovo_variants_core(std::vector<CandidateRegion*>& candidate_regions,
     const SampleIdText& sample_name, const fs::path& sample_outdir,
-    const DenovoDiscovery& denovo, uint32_t child_id, uint32_t threads)
+    const DenovoDiscovery& denovo, uint32_t child_id,
+    std::atomic<uint32_t>& next_candidate_region_index)
 {
     // create temp dir
     const auto temp_dir { sample_outdir / ("temp_child_" + int_to_string(child_id)) };
     fs::create_directories(temp_dir);
 
+    // each child takes the next candidate region not yet taken by any child, so that a
+    // few slow regions do not hold back a child while the others are idle
     CandidateRegionWriteBuffer buffer(sample_name);
-    for (uint32_t candidate_region_index = child_id;
+    for (uint32_t candidate_region_index = next_candidate_region_index++;
          candidate_region_index < candidate_regions.size();
-         candidate_region_index += threads) {
+         candidate_region_index = next_candidate_region_index++) {
         CandidateRegion& candidate_region { *(
             candidate_regions[candidate_region_index]) };
         denovo.find_paths_through_candidate_region(candidate_region, temp_dir);
@@ -234,18 +262,20 @@ void find_denovo_variants_core(std::vector<CandidateRegion*>& candidate_regions,
     }
 }
 
-void find_denovo_variants_multiprocess(CandidateRegions& candidate_regions,
+void find_denovo_variants_multiprocess(std::vector<CandidateRegion*>& candidate_regions,
     const SampleIdText& sample_name, const fs::path& sample_outdir,
-    const DenovoDiscovery& denovo, uint32_t threads)
+    const DenovoDiscovery& denovo, uint32_t threads, CandidateRegionWriteBuffer& buffer)
 {
-    // transforms CandidateRegions into a vector of pointers to CandidateRegion so that
-    // it is easier to multithread/multiprocess on it
-    std::vector<CandidateRegion*> candidate_regions_as_vector;
-    candidate_regions_as_vector.reserve(candidate_regions.size());
-    for (auto& element : candidate_regions) {
-        CandidateRegion* candidate_region_pointer = &(element.second);
-        candidate_regions_as_vector.push_back(candidate_region_pointer);
+    // the most expensive regions are taken first and the cheap ones fill in at the end
+    Discover::sort_candidate_regions_by_decreasing_cost(candidate_regions);
+
+    // index of the next candidate region to be processed, shared by all children
+    void* shared_memory = mmap(nullptr, sizeof(std::atomic<uint32_t>),
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared_memory == MAP_FAILED) {
+        fatal_error("Error creating the shared memory of the child processes.");
     }
+    auto* next_candidate_region_index = new (shared_memory) std::atomic<uint32_t>(0);
 
     // forking due to GATB
     size_t child_id;
@@ -266,8 +296,8 @@ void find_denovo_variants_multiprocess(CandidateRegions& candidate_regions,
     }
 
     if (on_child) {
-        find_denovo_variants_core(candidate_regions_as_vector, sample_name,
-            sample_outdir, denovo, child_id, threads);
+        find_denovo_variants_core(candidate_regions, sample_name,
+            sample_outdir, denovo, child_id, *next_candidate_region_index);
         std::exit(0);
     } else {
         // wait for all children to finish
@@ -282,10 +312,9 @@ void find_denovo_variants_multiprocess(CandidateRegions& candidate_regions,
             }
         }
     }
+    munmap(shared_memory, sizeof(std::atomic<uint32_t>));
 
-    // add all candidate region write buffers to a central one
-    CandidateRegionWriteBuffer buffer(sample_name);
-    std::vector<fs::path> buffer_binary_filenames;
+    // add all candidate region write buffers to the central one
     for (child_id = 0; child_id < threads; child_id++) {
         CandidateRegionWriteBuffer child_buffer;
         {
@@ -304,12 +333,6 @@ void find_denovo_variants_multiprocess(CandidateRegions& candidate_regions,
         }
         buffer.merge(child_buffer);
     }
-
-    auto denovo_output_file = sample_outdir / "denovo_paths.txt";
-    buffer.write_to_file(denovo_output_file);
-    BOOST_LOG_TRIVIAL(info) << "[Sample " << sample_name << "] "
-                            << "De novo variant paths written to "
-                            << denovo_output_file.string();
 }
 
 void pandora_discover_core(const std::pair<SampleIdText, SampleFpath>& sample,
@@ -336,7 +359,8 @@ void pandora_discover_core(const std::pair<SampleIdText, SampleFpath>& sample,
     uint32_t covg
         = pangraph_from_read_file(sample_fpath, pangraph, index, prgs, opt.window_size,
             opt.kmer_size, opt.max_diff, opt.error_rate, opt.min_cluster_size,
-            opt.genome_size, opt.illumina, opt.clean, opt.max_covg, opt.threads);
+            opt.genome_size, opt.illumina, opt.clean, opt.max_covg, opt.threads,
+            opt.query_window_size, 1, 0, opt.clean_by_component);
 
     const auto pangraph_gfa { sample_outdir / "pandora.pangraph.gfa" };
     BOOST_LOG_TRIVIAL(info) << "[Sample " << sample_name << "] "
@@ -434,17 +458,6 @@ void pandora_discover_core(const std::pair<SampleIdText, SampleFpath>& sample,
         }
     }
 
-    BOOST_LOG_TRIVIAL(info) << "[Sample " << sample_name << "] "
-                            << "Building read pileups for " << candidate_regions.size()
-                            << " candidate de novo regions...";
-    // the pileup_construction_map function is intentionally left
-    // single threaded since it would require too much synchronization
-    const auto pileup_construction_map
-        = discover.pileup_construction_map(candidate_regions);
-
-    discover.load_candidate_region_pileups(
-        sample_fpath, candidate_regions, pileup_construction_map, opt.threads);
-
     // remove the nodes marked as to be removed
     for (const auto& node_to_remove : nodes_to_remove) {
         pangraph->remove_node(node_to_remove);
@@ -465,11 +478,41 @@ void pandora_discover_core(const std::pair<SampleIdText, SampleFpath>& sample,
         opt.max_num_candidate_paths, opt.max_insertion_size,
         opt.min_covg_for_node_in_assembly_graph, opt.clean_dbg };
 
-    BOOST_LOG_TRIVIAL(info)
-        << "[Sample " << sample_name << "] "
-        << "Generating de novo variants as paths through their local graph...";
-    find_denovo_variants_multiprocess(
-        candidate_regions, sample_name, sample_outdir, denovo, opt.threads);
+    // the pileups of each wave of candidate regions are built, assembled and released
+    // before the next wave, so that only one wave of pileups is in memory at a time
+    auto candidate_region_waves = Discover::get_candidate_region_waves(
+        candidate_regions, (uint64_t)opt.max_pileup_memory * 1024 * 1024);
+    CandidateRegionWriteBuffer buffer(sample_name);
+    for (uint32_t wave_index = 0; wave_index < candidate_region_waves.size();
+         ++wave_index) {
+        auto& wave = candidate_region_waves[wave_index];
+        BOOST_LOG_TRIVIAL(info) << "[Sample " << sample_name << "] "
+                                << "Building read pileups for " << wave.size()
+                                << " candidate de novo regions (wave "
+                                << wave_index + 1 << " of "
+                                << candidate_region_waves.size() << ")...";
+        // the pileup_construction_map function is intentionally left
+        // single threaded since it would require too much synchronization
+        const auto pileup_construction_map = discover.pileup_construction_map(wave);
+        discover.load_candidate_region_pileups(
+            sample_fpath, candidate_regions, pileup_construction_map, opt.threads);
+
+        BOOST_LOG_TRIVIAL(info)
+            << "[Sample " << sample_name << "] "
+            << "Generating de novo variants as paths through their local graph...";
+        find_denovo_variants_multiprocess(
+            wave, sample_name, sample_outdir, denovo, opt.threads, buffer);
+
+        for (CandidateRegion* candidate_region : wave) {
+            candidate_region->release_pileup();
+        }
+    }
+
+    auto denovo_output_file = sample_outdir / "denovo_paths.txt";
+    buffer.write_to_file(denovo_output_file);
+    BOOST_LOG_TRIVIAL(info) << "[Sample " << sample_name << "] "
+                            << "De novo variant paths written to "
+                            << denovo_output_file.string();
 
     if (opt.output_mapped_read_fa) {
         pangraph->save_mapped_read_strings(sample_fpath, sample_outdir);
@@ -525,7 +568,7 @@ int pandora_discover(DiscoverOptions& opt)
     auto index = std::make_shared<Index>();
     index->load(opt.prgfile, opt.window_size, opt.kmer_size);
     std::vector<std::shared_ptr<LocalPRG>> prgs;
-    read_prg_file(prgs, opt.prgfile);
+    read_prg_file(prgs, opt.prgfile, 0, {}, true);
     load_PRG_kmergraphs(prgs, opt.window_size, opt.kmer_size, opt.prgfile);
 
     BOOST_LOG_TRIVIAL(info) << "Loading read index file...";
@@ -1,34 +1,262 @@
 #include <string>
 #include <iostream>
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "fastaq_handler.h"
 
 FastaqHandler::FastaqHandler(const std::string filepath)
-    : closed(false)
-    , filepath(filepath)
+    : FastaqHandler(split_filepaths(filepath))
+{
+}
+
+FastaqHandler::FastaqHandler(const std::vector<std::string>& filepaths)
+    : closed(true)
+    , inbuf(nullptr)
+    , filepaths(filepaths)
+    , current_file_idx(0)
+    , mapped_data(nullptr)
+    , mapped_size(0)
+    , mapped_pos(0)
+    , fastaq_file(nullptr)
     , num_reads_parsed(0)
 {
-    this->fastaq_file = gzopen(filepath.c_str(), "r");
+    if (this->filepaths.empty()) {
+        throw std::ios_base::failure("No read file was given");
+    }
+    this->open_file(0);
+}
+
+FastaqHandler::~FastaqHandler() { this->close(); }
+
+std::vector<std::string> FastaqHandler::split_filepaths(const std::string& filepaths)
+{
+    // a path to an existing file is not split, even if its name has a comma
+    struct stat file_status;
+    if (stat(filepaths.c_str(), &file_status) == 0 and S_ISREG(file_status.st_mode)) {
+        return { filepaths };
+    }
+
+    std::vector<std::string> split_filepaths;
+    std::istringstream filepaths_stream(filepaths);
+    std::string filepath;
+    while (std::getline(filepaths_stream, filepath, ',')) {
+        if (!filepath.empty()) {
+            split_filepaths.push_back(filepath);
+        }
+    }
+    return split_filepaths;
+}
+
+void FastaqHandler::open_file(const size_t file_idx)
+{
+    this->current_file_idx = file_idx;
+    this->filepath = this->filepaths[file_idx];
+    if (this->map_current_file()) {
+        this->closed = false;
+        return;
+    }
+
+    this->fastaq_file = gzopen(this->filepath.c_str(), "r");
     if (this->fastaq_file == nullptr) {
         throw std::ios_base::failure("Unable to open " + this->filepath);
     }
     this->inbuf = kseq_init(this->fastaq_file);
+    this->closed = false;
 }
 
-FastaqHandler::~FastaqHandler() { this->close(); }
+// Maps the current file into memory if it is a non-empty, uncompressed, regular file.
+// Returns false if the file has to be read through zlib instead.
+bool FastaqHandler::map_current_file()
+{
+    const int fd = ::open(this->filepath.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false; // gzopen reports the error
+    }
 
-bool FastaqHandler::eof() const { return ks_eof(this->inbuf->f); }
+    struct stat file_stat;
+    unsigned char magic_number[2];
+    const bool is_gzipped = pread(fd, magic_number, 2, 0) == 2
+        and magic_number[0] == 0x1f and magic_number[1] == 0x8b;
+    const bool is_mappable = fstat(fd, &file_stat) == 0 and S_ISREG(file_stat.st_mode)
+        and file_stat.st_size > 0 and not is_gzipped;
 
-void FastaqHandler::get_next()
+    if (is_mappable) {
+        const size_t file_size = file_stat.st_size;
+        void* data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            madvise(data, file_size, MADV_SEQUENTIAL);
+            this->mapped_data = static_cast<const char*>(data);
+            this->mapped_size = file_size;
+            this->mapped_pos = 0;
+        }
+    }
+    ::close(fd);
+    return this->is_memory_mapped();
+}
+
+void FastaqHandler::close_current_file()
 {
-    if (this->eof()) {
-        throw std::out_of_range("Read requested after the end of file was reached");
+    this->closed = true;
+    if (this->is_memory_mapped()) {
+        munmap(const_cast<char*>(this->mapped_data), this->mapped_size);
+        this->mapped_data = nullptr;
+        this->mapped_size = 0;
+        this->mapped_pos = 0;
+        return;
+    }
+
+    const auto closed_status = gzclose(this->fastaq_file);
+    kseq_destroy(this->inbuf);
+    this->fastaq_file = nullptr;
+    this->inbuf = nullptr;
+
+    if (closed_status != Z_OK) {
+        std::ostringstream err_msg;
+        err_msg << "Failed to close " << this->filepath
+                << ". Got zlib return code: " << closed_status << std::endl;
+        throw std::ios_base::failure(err_msg.str());
     }
-    int read_status = kseq_read(this->inbuf);
+}
+
+bool FastaqHandler::has_next_file() const
+{
+    return this->current_file_idx + 1 < this->filepaths.size();
+}
+
+bool FastaqHandler::eof() const
+{
+    const bool current_file_eof = this->is_memory_mapped()
+        ? this->mapped_pos >= this->mapped_size
+        : ks_eof(this->inbuf->f);
+    return current_file_eof and not this->has_next_file();
+}
 
-    // if not eof but we get -1 here then it was an empty file/read/line
-    if (read_status == -1) {
-        throw std::out_of_range("Read requested after the end of file was reached");
+namespace {
+// end of the line starting at line_start, excluding the newline and any carriage return
+const char* find_line_end(const char* line_start, const char* data_end)
+{
+    const char* newline = static_cast<const char*>(
+        std::memchr(line_start, '\n', data_end - line_start));
+    const char* line_end = newline == nullptr ? data_end : newline;
+    if (line_end > line_start and *(line_end - 1) == '\r') {
+        --line_end;
     }
+    return line_end;
+}
+
+const char* find_next_line(const char* line_start, const char* data_end)
+{
+    const char* newline = static_cast<const char*>(
+        std::memchr(line_start, '\n', data_end - line_start));
+    return newline == nullptr ? data_end : newline + 1;
+}
+}
+
+// Parses the record starting at mapped_pos following the same rules as kseq_read:
+// single-line sequences are viewed in place, multi-line ones are joined in
+// multiline_sequence. Returns -1 at the end of the file and -2 on a truncated
+// quality string.
+int FastaqHandler::read_mapped_record()
+{
+    const char* const data_end = this->mapped_data + this->mapped_size;
+    const char* position = this->mapped_data + this->mapped_pos;
+
+    // skip anything before the next header
+    while (position < data_end and *position != '>' and *position != '@') {
+        ++position;
+    }
+    if (position == data_end) {
+        this->mapped_pos = this->mapped_size;
+        return -1;
+    }
+
+    const char* const header_end = find_line_end(position, data_end);
+    const char* const name_start = position + 1;
+    const char* name_end = name_start;
+    while (name_end < header_end and not std::isspace((unsigned char)*name_end)) {
+        ++name_end;
+    }
+    this->name_view = boost::string_ref(name_start, name_end - name_start);
+    position = find_next_line(position, data_end);
+
+    // sequence lines run until the next header or the quality separator
+    uint32_t number_of_sequence_lines = 0;
+    size_t sequence_length = 0;
+    while (position < data_end and *position != '>' and *position != '+'
+        and *position != '@') {
+        const char* const line_end = find_line_end(position, data_end);
+        if (number_of_sequence_lines == 0) {
+            this->read_view = boost::string_ref(position, line_end - position);
+        } else {
+            if (number_of_sequence_lines == 1) {
+                this->multiline_sequence.assign(
+                    this->read_view.data(), this->read_view.size());
+            }
+            this->multiline_sequence.append(position, line_end - position);
+        }
+        sequence_length += line_end - position;
+        ++number_of_sequence_lines;
+        position = find_next_line(position, data_end);
+    }
+    if (number_of_sequence_lines == 0) {
+        this->read_view = boost::string_ref();
+    } else if (number_of_sequence_lines > 1) {
+        this->read_view = boost::string_ref(this->multiline_sequence);
+    }
+
+    const bool is_fastq = position < data_end and *position == '+';
+    if (is_fastq) {
+        position = find_next_line(position, data_end);
+        size_t quality_length = 0;
+        do {
+            if (position == data_end) {
+                break;
+            }
+            const char* const line_end = find_line_end(position, data_end);
+            quality_length += line_end - position;
+            position = find_next_line(position, data_end);
+        } while (quality_length < sequence_length);
+
+        if (quality_length != sequence_length) {
+            this->mapped_pos = position - this->mapped_data;
+            return -2;
+        }
+    }
+
+    while (position < data_end and std::isspace((unsigned char)*position)) {
+        ++position;
+    }
+    this->mapped_pos = position - this->mapped_data;
+    return (int)sequence_length;
+}
+
+void FastaqHandler::get_next_view()
+{
+    int read_status;
+    while (true) {
+        read_status = -1;
+        if (this->is_memory_mapped()) {
+            read_status = this->read_mapped_record();
+        } else if (!ks_eof(this->inbuf->f)) {
+            read_status = kseq_read(this->inbuf);
+        }
+        // if not eof but we get -1 here then it was an empty file/read/line
+        if (read_status != -1) {
+            break;
+        }
+        if (!this->has_next_file()) {
+            throw std::out_of_range(
+                "Read requested after the end of file was reached");
+        }
+        // carry on with the next file, keeping the read count going
+        this->close_current_file();
+        this->open_file(this->current_file_idx + 1);
+    }
+
     if (read_status == -2) {
         throw std::runtime_error("Truncated quality string detected");
     } else if (read_status == -3) {
@@ -36,8 +264,17 @@ void FastaqHandler::get_next()
     }
 
     ++this->num_reads_parsed;
-    this->name = this->inbuf->name.s;
-    this->read = this->inbuf->seq.s;
+    if (!this->is_memory_mapped()) {
+        this->name_view = boost::string_ref(this->inbuf->name.s, this->inbuf->name.l);
+        this->read_view = boost::string_ref(this->inbuf->seq.s, this->inbuf->seq.l);
+    }
+}
+
+void FastaqHandler::get_next()
+{
+    this->get_next_view();
+    this->name.assign(this->name_view.data(), this->name_view.size());
+    this->read.assign(this->read_view.data(), this->read_view.size());
 }
 
 void FastaqHandler::get_nth_read(const uint32_t& idx)
@@ -51,29 +288,66 @@ void FastaqHandler::get_nth_read(const uint32_t& idx)
         num_reads_parsed = 0;
         name.clear();
         read.clear();
-        gzrewind(this->fastaq_file);
-        kseq_rewind(this->inbuf);
+        if (this->current_file_idx == 0 and this->is_memory_mapped()) {
+            this->mapped_pos = 0;
+        } else if (this->current_file_idx == 0) {
+            gzrewind(this->fastaq_file);
+            kseq_rewind(this->inbuf);
+        } else {
+            this->close_current_file();
+            this->open_file(0);
+        }
     }
 
+    // records skipped over are not copied
     while (this->num_reads_parsed < one_based_idx) {
-        this->get_next();
+        this->get_next_view();
     }
+    this->name.assign(this->name_view.data(), this->name_view.size());
+    this->read.assign(this->read_view.data(), this->read_view.size());
 }
 
 void FastaqHandler::close()
 {
     if (!this->is_closed()) {
-        const auto closed_status = gzclose(this->fastaq_file);
-        kseq_destroy(this->inbuf);
-
-        if (closed_status != Z_OK) {
-            std::ostringstream err_msg;
-            err_msg << "Failed to close " << this->filepath
-                    << ". Got zlib return code: " << closed_status << std::endl;
-            throw std::ios_base::failure(err_msg.str());
-        }
-        this->closed = true;
+        this->close_current_file();
     }
 }
 
 bool FastaqHandler::is_closed() const { return this->closed; }
+
+bool FastaqHandler::is_memory_mapped() const { return this->mapped_data != nullptr; }
+
+size_t FastaqHandler::get_mapped_position() const
+{
+    if (!this->is_memory_mapped()) {
+        throw std::ios_base::failure("Cannot get the position in " + this->filepath
+            + ": it is not memory-mapped");
+    }
+    return this->mapped_pos;
+}
+
+void FastaqHandler::seek_mapped_position(const size_t position)
+{
+    if (!this->is_memory_mapped()) {
+        throw std::ios_base::failure(
+            "Cannot seek in " + this->filepath + ": it is not memory-mapped");
+    }
+    if (position > this->mapped_size) {
+        throw std::ios_base::failure("Cannot seek to position "
+            + std::to_string(position) + " of " + this->filepath + ": it only has "
+            + std::to_string(this->mapped_size) + " bytes");
+    }
+    this->mapped_pos = position;
+}
+
+bool FastaqHandler::mapped_position_starts_record(const size_t position) const
+{
+    if (!this->is_memory_mapped() or position >= this->mapped_size) {
+        return false;
+    }
+    const char first_char = this->mapped_data[position];
+    const bool starts_header = first_char == '>' or first_char == '@';
+    const bool starts_line = position == 0 or this->mapped_data[position - 1] == '\n';
+    return starts_header and starts_line;
+}
@@ -62,6 +62,13 @@ void Index::save(const fs::path& indexfile)
     fs::ofstream handle;
     handle.open(indexfile);
 
+    // minimizer indices have no header, as before syncmers were supported
+    if (syncmer_size > 0) {
+        handle << "#syncmer_size\t" << syncmer_size << std::endl;
+        if (window_size > 0) {
+            handle << "#window_size\t" << window_size << std::endl;
+        }
+    }
     handle << minhash.size() << std::endl;
 
     for (auto& it : minhash) {
@@ -76,14 +83,25 @@ void Index::save(const fs::path& indexfile)
                              << " entries to file";
 }
 
-void Index::load(fs::path prgfile, uint32_t w, uint32_t k)
+void Index::load(fs::path prgfile, uint32_t w, uint32_t k,
+    const std::unordered_set<uint32_t>& prg_ids_to_load)
 {
     const auto ext { ".k" + std::to_string(k) + ".w" + std::to_string(w) + ".idx" };
     prgfile += ext;
-    load(prgfile);
+    load(prgfile, prg_ids_to_load);
+
+    // the window size only names the files of a syncmer index, so it would otherwise
+    // be silently ignored
+    const bool window_size_is_consistent = window_size == 0 or window_size == w;
+    if (!window_size_is_consistent) {
+        fatal_error("Error loading index file ", prgfile,
+            ": it was built with syncmers and window size ", window_size,
+            ", which must also be the window size given (", w, ")");
+    }
 }
 
-void Index::load(const fs::path& indexfile)
+void Index::load(
+    const fs::path& indexfile, const std::unordered_set<uint32_t>& prg_ids_to_load)
 {
     BOOST_LOG_TRIVIAL(debug) << "Loading index";
     BOOST_LOG_TRIVIAL(debug) << "File is " << indexfile;
@@ -92,14 +110,32 @@ void Index::load(const fs::path& indexfile)
     int c;
     MiniRecord mr;
     bool first = true;
+    const bool load_all_prgs = prg_ids_to_load.empty();
+    const bool index_was_empty = minhash.empty();
+    uint32_t file_syncmer_size = 0;
+    uint32_t file_window_size = 0;
 
     fs::ifstream myfile(indexfile);
     if (myfile.is_open()) {
         while (myfile.good()) {
             c = myfile.peek();
-            if (isdigit(c) and first) {
+            if (c == '#' and first) {
+                std::string field;
+                myfile >> field;
+                if (field == "#syncmer_size") {
+                    myfile >> file_syncmer_size;
+                } else if (field == "#window_size") {
+                    myfile >> file_window_size;
+                } else {
+                    fatal_error("Error loading index file ", indexfile,
+                        ": unknown header field ", field);
+                }
+                myfile.ignore(1, '\n');
+            } else if (isdigit(c) and first) {
                 myfile >> size;
-                minhash.reserve(minhash.size() + size);
+                if (load_all_prgs) {
+                    minhash.reserve(minhash.size() + size);
+                }
                 first = false;
                 myfile.ignore(1, '\t');
             } else if (isdigit(c) and !first) {
@@ -109,9 +145,13 @@ void Index::load(const fs::path& indexfile)
                 auto* vmr = new std::vector<MiniRecord>;
                 if (minhash.find(key) != minhash.end()) {
                     vmr = minhash[key];
-                    vmr->reserve(vmr->size() + size);
+                    if (load_all_prgs) {
+                        vmr->reserve(vmr->size() + size);
+                    }
                 } else {
-                    vmr->reserve(size);
+                    if (load_all_prgs) {
+                        vmr->reserve(size);
+                    }
                     minhash[key] = vmr;
                 }
                 myfile.ignore(1, '\t');
@@ -119,7 +159,10 @@ void Index::load(const fs::path& indexfile)
                 break;
             } else {
                 myfile >> mr;
-                minhash[key]->push_back(mr);
+                if (load_all_prgs
+                    or prg_ids_to_load.find(mr.prg_id) != prg_ids_to_load.end()) {
+                    minhash[key]->push_back(mr);
+                }
                 myfile.ignore(1, '\t');
             }
         }
@@ -128,6 +171,29 @@ void Index::load(const fs::path& indexfile)
             ". Does it exist? Have you run pandora index?");
     }
 
+    const bool sketch_is_consistent = index_was_empty
+        or (file_syncmer_size == syncmer_size and file_window_size == window_size);
+    if (!sketch_is_consistent) {
+        fatal_error("Error loading index file ", indexfile, ": its syncmer size (",
+            file_syncmer_size, ") or window size (", file_window_size,
+            ") differs from the one of the indices already loaded (", syncmer_size,
+            ", ", window_size, "). Only indices sketched the same way can be merged");
+    }
+    syncmer_size = file_syncmer_size;
+    window_size = file_window_size;
+
+    // minimizers with no records in the PRGs loaded are not needed
+    if (!load_all_prgs) {
+        for (auto it = minhash.begin(); it != minhash.end();) {
+            if (it->second->empty()) {
+                delete it->second;
+                it = minhash.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
     if (minhash.size() <= 1) {
         BOOST_LOG_TRIVIAL(debug)
             << "Was this file empty?! Index now contains a trivial " << minhash.size()
@@ -140,7 +206,9 @@ void Index::load(const fs::path& indexfile)
 
 bool Index::operator==(const Index& other) const
 {
-    if (this->minhash.size() != other.minhash.size()) {
+    if (this->syncmer_size != other.syncmer_size
+        or this->window_size != other.window_size
+        or this->minhash.size() != other.minhash.size()) {
         return false;
     }
 
@@ -176,7 +244,8 @@ bool Index::operator!=(const Index& other) const { return !(*this == other); }
 
 void index_prgs(std::vector<std::shared_ptr<LocalPRG>>& prgs,
     std::shared_ptr<Index>& index, const uint32_t w, const uint32_t k,
-    const fs::path& outdir, uint32_t threads)
+    const fs::path& outdir, uint32_t threads, const uint32_t first_prg_position,
+    const bool save_vcf_sites, const VCFRefs& vcf_refs)
 {
     BOOST_LOG_TRIVIAL(debug) << "Index PRGs";
     if (prgs.empty())
@@ -185,27 +254,49 @@ void index_prgs(std::vector<std::shared_ptr<LocalPRG>>& prgs,
     // first reserve an estimated index size
     uint32_t r = 0;
     for (uint32_t i = 0; i != prgs.size(); ++i) {
-        r += prgs[i]->seq.length();
+        r += prgs[i]->get_seq_length();
     }
     index->minhash.reserve(r);
 
     // create the dirs for the index
     const int nbOfGFAsPerDir = 4000;
-    for (uint32_t i = 0; i <= prgs.size() / nbOfGFAsPerDir; ++i)
+    const uint32_t end_prg_position = first_prg_position + prgs.size();
+    for (uint32_t i = first_prg_position / nbOfGFAsPerDir;
+         i <= end_prg_position / nbOfGFAsPerDir; ++i)
         fs::create_directories(outdir / int_to_string(i + 1));
 
     // now fill index
     std::atomic_uint32_t nbOfPRGsDone { 0 };
 #pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
     for (uint32_t i = 0; i < prgs.size(); ++i) { // for each prg
-        uint32_t dir = i / nbOfGFAsPerDir + 1;
-        prgs[i]->minimizer_sketch(
-            index, w, k, (((double)(nbOfPRGsDone.load())) / prgs.size()) * 100);
+        uint32_t dir = (first_prg_position + i) / nbOfGFAsPerDir + 1;
+        const double percentageDone
+            = (((double)(nbOfPRGsDone.load())) / prgs.size()) * 100;
+        if (index->syncmer_size > 0) {
+            prgs[i]->syncmer_sketch(index, k, index->syncmer_size, percentageDone);
+        } else {
+            prgs[i]->minimizer_sketch(index, w, k, percentageDone);
+        }
         const auto gfa_file { outdir / int_to_string(dir)
             / (prgs[i]->name + ".k" + std::to_string(k) + ".w" + std::to_string(w)
                 + ".gfa") };
         prgs[i]->kmer_prg.save(gfa_file);
 
+        if (save_vcf_sites) {
+            std::vector<LocalNodePtr> vcf_reference_path;
+            const auto vcf_ref_it = vcf_refs.find(prgs[i]->name);
+            if (vcf_ref_it != vcf_refs.end()) {
+                vcf_reference_path
+                    = prgs[i]->get_valid_vcf_reference(vcf_ref_it->second);
+            }
+            if (vcf_reference_path.empty()) {
+                vcf_reference_path = prgs[i]->prg.top_path();
+            }
+            prgs[i]->save_vcf_sites(
+                outdir / int_to_string(dir) / (prgs[i]->name + ".vcf_sites"),
+                vcf_reference_path);
+        }
+
         ++nbOfPRGsDone;
     }
     BOOST_LOG_TRIVIAL(debug) << "Finished adding " << prgs.size() << " LocalPRGs";
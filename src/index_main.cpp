@@ -21,15 +21,47 @@ void setup_index_subcommand(CLI::App& app)
         ->type_name("INT")
         ->capture_default_str();
 
+    index_subcmd
+        ->add_option("--syncmer", opt->syncmer_size,
+            "Sketch PRGs with open syncmers, the k-mers whose smallest s-mer of this "
+            "size (must be <k) is their first one, instead of (w,k)-minimizers. This "
+            "is recorded in the index, so map, compare and discover sketch reads the "
+            "same way. -w then only names the output files, and is recorded in the "
+            "index so that they are given the same -w")
+        ->type_name("INT");
+
     index_subcmd
         ->add_option("-t,--threads", opt->threads, "Maximum number of threads to use")
         ->type_name("INT")
         ->capture_default_str();
 
+    index_subcmd
+        ->add_option("--slice", opt->slice,
+            "Only index a slice of the PRGs, given as the PRG positions START-END "
+            "(0-based, END excluded) or as I/N, the I-th of N slices of about the same "
+            "size. Uncompressed PRG files are seeked to the slice using record offsets "
+            "saved in <PRG>.offsets. Merge the indices of the slices with merge_index")
+        ->type_name("STR");
+
+    auto* save_vcf_sites_opt = index_subcmd->add_flag("--save-vcf-sites",
+        opt->save_vcf_sites,
+        "Save the VCF sites of each loci along its top path next to its k-mer graph, "
+        "so that map and compare reuse them when building its VCF from the same path");
+
+    index_subcmd
+        ->add_option("--vcf-refs", opt->vcf_refs_file,
+            "Fasta file with a reference sequence for each loci, as given to map and "
+            "compare. The VCF sites saved are then found along these references "
+            "(or along the top path of the loci not in the file)")
+        ->type_name("FILE")
+        ->transform(make_absolute)
+        ->check(CLI::ExistingFile.description(""))
+        ->needs(save_vcf_sites_opt);
+
     index_subcmd->add_option("-o,--outfile", opt->outfile, "Filename for the index")
         ->type_name("FILE")
         ->transform(make_absolute)
-        ->default_str("<PRG>.kXX.wXX.idx");
+        ->default_str("<PRG>.kXX.wXX.idx, or <PRG>.sliceSTART-END.kXX.wXX.idx");
 
     index_subcmd->add_flag(
         "-v", opt->verbosity, "Verbosity of logging. Repeat for increased verbosity");
@@ -57,25 +89,47 @@ int pandora_index(IndexOptions const& opt)
     if (opt.kmer_size <= 0) {
         throw std::logic_error("K must be a positive integer");
     }
+    if (opt.syncmer_size >= opt.kmer_size) {
+        throw std::logic_error("The syncmer s-mer size must be smaller than K");
+    }
 
     LocalPRG::do_path_memoization_in_nodes_along_path_method = true;
 
     // load PRGs from file
     std::vector<std::shared_ptr<LocalPRG>> prgs;
-    read_prg_file(prgs, opt.prgfile, opt.id_offset);
+    uint32_t first_prg_position = 0;
+    if (opt.slice.empty()) {
+        read_prg_file(prgs, opt.prgfile, opt.id_offset);
+    } else {
+        first_prg_position = read_prg_file_slice(
+            prgs, opt.prgfile, PrgSlice::from_string(opt.slice), opt.id_offset);
+    }
 
     // get output directory for the gfa
     const auto kmer_prgs_outdir { opt.prgfile.parent_path() / "kmer_prgs" };
 
     BOOST_LOG_TRIVIAL(info) << "Indexing PRG...";
     auto index = std::make_shared<Index>();
-    index_prgs(
-        prgs, index, opt.window_size, opt.kmer_size, kmer_prgs_outdir, opt.threads);
+    index->syncmer_size = opt.syncmer_size;
+    if (opt.syncmer_size > 0) {
+        index->window_size = opt.window_size;
+    }
+    VCFRefs vcf_refs;
+    if (!opt.vcf_refs_file.empty()) {
+        load_vcf_refs_file(opt.vcf_refs_file, vcf_refs);
+    }
+    index_prgs(prgs, index, opt.window_size, opt.kmer_size, kmer_prgs_outdir,
+        opt.threads, first_prg_position, opt.save_vcf_sites, vcf_refs);
 
     // save index
     BOOST_LOG_TRIVIAL(info) << "Saving index...";
     if (not opt.outfile.empty()) {
         index->save(opt.outfile);
+    } else if (not opt.slice.empty()) {
+        const fs::path outfile { opt.prgfile.string() + ".slice"
+            + std::to_string(first_prg_position) + "-"
+            + std::to_string(first_prg_position + prgs.size()) };
+        index->save(outfile, opt.window_size, opt.kmer_size);
     } else if (opt.id_offset > 0) {
         const fs::path outfile { opt.prgfile.string() + "."
             + std::to_string(opt.id_offset) };
@@ -0,0 +1,148 @@
+#include "kmer_hashing.h"
+#include "inthash.h"
+#include "fatal_error.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PANDORA_X86_64_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+void hash_kmers_scalar(const uint64_t* kmers, uint64_t* hashes,
+    const size_t number_of_kmers, const uint64_t mask)
+{
+    for (size_t i = 0; i < number_of_kmers; ++i) {
+        hashes[i] = hash64(kmers[i], mask);
+    }
+}
+
+#ifdef PANDORA_X86_64_KERNELS
+// each step is the same as in hash64, on 2 lanes of 64 bits. SSE2 is part of x86-64,
+// so this kernel needs no runtime check
+void hash_kmers_sse2(const uint64_t* kmers, uint64_t* hashes,
+    const size_t number_of_kmers, const uint64_t mask)
+{
+    const __m128i mask_lanes = _mm_set1_epi64x((long long)mask);
+    const __m128i all_ones = _mm_set1_epi64x(-1);
+    size_t i = 0;
+    for (; i + 2 <= number_of_kmers; i += 2) {
+        __m128i key = _mm_loadu_si128((const __m128i*)(kmers + i));
+        key = _mm_and_si128(
+            _mm_add_epi64(_mm_xor_si128(key, all_ones), _mm_slli_epi64(key, 21)),
+            mask_lanes);
+        key = _mm_xor_si128(key, _mm_srli_epi64(key, 24));
+        key = _mm_and_si128(_mm_add_epi64(_mm_add_epi64(key, _mm_slli_epi64(key, 3)),
+                                _mm_slli_epi64(key, 8)),
+            mask_lanes);
+        key = _mm_xor_si128(key, _mm_srli_epi64(key, 14));
+        key = _mm_and_si128(_mm_add_epi64(_mm_add_epi64(key, _mm_slli_epi64(key, 2)),
+                                _mm_slli_epi64(key, 4)),
+            mask_lanes);
+        key = _mm_xor_si128(key, _mm_srli_epi64(key, 28));
+        key = _mm_and_si128(_mm_add_epi64(key, _mm_slli_epi64(key, 31)), mask_lanes);
+        _mm_storeu_si128((__m128i*)(hashes + i), key);
+    }
+    hash_kmers_scalar(kmers + i, hashes + i, number_of_kmers - i, mask);
+}
+
+// same as hash_kmers_sse2, on 4 lanes
+__attribute__((target("avx2"))) void hash_kmers_avx2(const uint64_t* kmers,
+    uint64_t* hashes, const size_t number_of_kmers, const uint64_t mask)
+{
+    const __m256i mask_lanes = _mm256_set1_epi64x((long long)mask);
+    const __m256i all_ones = _mm256_set1_epi64x(-1);
+    size_t i = 0;
+    for (; i + 4 <= number_of_kmers; i += 4) {
+        __m256i key = _mm256_loadu_si256((const __m256i*)(kmers + i));
+        key = _mm256_and_si256(_mm256_add_epi64(_mm256_xor_si256(key, all_ones),
+                                   _mm256_slli_epi64(key, 21)),
+            mask_lanes);
+        key = _mm256_xor_si256(key, _mm256_srli_epi64(key, 24));
+        key = _mm256_and_si256(
+            _mm256_add_epi64(_mm256_add_epi64(key, _mm256_slli_epi64(key, 3)),
+                _mm256_slli_epi64(key, 8)),
+            mask_lanes);
+        key = _mm256_xor_si256(key, _mm256_srli_epi64(key, 14));
+        key = _mm256_and_si256(
+            _mm256_add_epi64(_mm256_add_epi64(key, _mm256_slli_epi64(key, 2)),
+                _mm256_slli_epi64(key, 4)),
+            mask_lanes);
+        key = _mm256_xor_si256(key, _mm256_srli_epi64(key, 28));
+        key = _mm256_and_si256(
+            _mm256_add_epi64(key, _mm256_slli_epi64(key, 31)), mask_lanes);
+        _mm256_storeu_si256((__m256i*)(hashes + i), key);
+    }
+    hash_kmers_scalar(kmers + i, hashes + i, number_of_kmers - i, mask);
+}
+#endif
+}
+
+std::string to_string(const KmerHashingKernel kernel)
+{
+    switch (kernel) {
+    case KmerHashingKernel::scalar:
+        return "scalar";
+    case KmerHashingKernel::sse2:
+        return "SSE2";
+    case KmerHashingKernel::avx2:
+        return "AVX2";
+    }
+    return "unknown";
+}
+
+bool kmer_hashing_kernel_is_supported(const KmerHashingKernel kernel)
+{
+    switch (kernel) {
+    case KmerHashingKernel::scalar:
+        return true;
+#ifdef PANDORA_X86_64_KERNELS
+    case KmerHashingKernel::sse2:
+        return true;
+    case KmerHashingKernel::avx2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+KmerHashingKernel get_best_kmer_hashing_kernel()
+{
+    static const KmerHashingKernel best_kernel = []() {
+        for (const auto kernel : { KmerHashingKernel::avx2, KmerHashingKernel::sse2 }) {
+            if (kmer_hashing_kernel_is_supported(kernel)) {
+                return kernel;
+            }
+        }
+        return KmerHashingKernel::scalar;
+    }();
+    return best_kernel;
+}
+
+void hash_kmers(const uint64_t* kmers, uint64_t* hashes, const size_t number_of_kmers,
+    const uint64_t mask)
+{
+    hash_kmers(kmers, hashes, number_of_kmers, mask, get_best_kmer_hashing_kernel());
+}
+
+void hash_kmers(const uint64_t* kmers, uint64_t* hashes, const size_t number_of_kmers,
+    const uint64_t mask, const KmerHashingKernel kernel)
+{
+    if (!kmer_hashing_kernel_is_supported(kernel)) {
+        fatal_error("Error hashing k-mers: the ", to_string(kernel),
+            " kernel is not supported by this CPU");
+    }
+
+    switch (kernel) {
+#ifdef PANDORA_X86_64_KERNELS
+    case KmerHashingKernel::sse2:
+        hash_kmers_sse2(kmers, hashes, number_of_kmers, mask);
+        break;
+    case KmerHashingKernel::avx2:
+        hash_kmers_avx2(kmers, hashes, number_of_kmers, mask);
+        break;
+#endif
+    default:
+        hash_kmers_scalar(kmers, hashes, number_of_kmers, mask);
+    }
+}
@@ -31,8 +31,7 @@ KmerGraph::KmerGraph(const KmerGraph& other)
     // create deep copies of the nodes, minus the edges
     for (const auto& node : other.nodes) {
         n = std::make_shared<KmerNode>(*node);
-        nodes.push_back(n);
-        sorted_nodes.insert(n);
+        index_node(n);
     }
 
     // now need to copy the edges
@@ -62,8 +61,7 @@ KmerGraph& KmerGraph::operator=(const KmerGraph& other)
     // create deep copies of the nodes, minus the edges
     for (const auto& node : other.nodes) {
         n = std::make_shared<KmerNode>(*node);
-        nodes.push_back(n);
-        sorted_nodes.insert(n);
+        index_node(n);
     }
 
     // now need to copy the edges
@@ -80,22 +78,38 @@ void KmerGraph::clear()
 {
     nodes.clear();
     sorted_nodes.clear();
+    path_hash_to_nodes.clear();
     shortest_path_length = 0;
     k = 0;
 }
 
+void KmerGraph::index_node(const KmerNodePtr& node)
+{
+    nodes.push_back(node);
+    sorted_nodes.insert(node);
+    path_hash_to_nodes.emplace(std::hash<prg::Path>()(node->path), node);
+}
+
 KmerNodePtr KmerGraph::add_node(const prg::Path& p)
 { // add this kmer path to this kmer graph
-    for (const auto& c : nodes) { // check if this kmer path is already added
-        if (c->path == p) { // TODO: overload operator == to receive a prg::Path?
-            return c;
+    const size_t path_hash = std::hash<prg::Path>()(p);
+    const auto nodes_with_same_hash = path_hash_to_nodes.equal_range(path_hash);
+    KmerNodePtr existing_node = nullptr;
+    for (auto it = nodes_with_same_hash.first; it != nodes_with_same_hash.second;
+         ++it) { // check if this kmer path is already added
+        const bool is_first_node_with_path = it->second->path == p
+            and (existing_node == nullptr or it->second->id < existing_node->id);
+        if (is_first_node_with_path) {
+            existing_node = it->second;
         }
     }
+    if (existing_node != nullptr) {
+        return existing_node;
+    }
 
     // if we didn't find an existing node, add this kmer path to the graph
     KmerNodePtr n(std::make_shared<KmerNode>(nodes.size(), p)); // create the node
-    nodes.push_back(n); // add it to nodes
-    sorted_nodes.insert(n);
+    index_node(n);
 
     const bool path_is_valid = k == 0 or p.length() == 0 or p.length() == k;
     if (!path_is_valid) {
@@ -161,15 +175,23 @@ void KmerGraph::remove_shortcut_edges()
     std::vector<KmerNodePtr> v = {};
     std::deque<std::vector<KmerNodePtr>> d;
 
+    // out_node_marks[id] == n->id + 1 iff the node with this id is an outnode of n, so
+    // that finding if a node two hops away is also one hop away is a single lookup
+    std::vector<uint32_t> out_node_marks(nodes.size(), 0);
+
     for (const auto& n : nodes) {
+        const uint32_t mark = n->id + 1;
+        for (const auto& out : n->out_nodes) {
+            out_node_marks[out.lock()->id] = mark;
+        }
+
         for (const auto& out : n->out_nodes) {
             auto out_node_as_shared_ptr = out.lock();
             for (auto nextOut = out_node_as_shared_ptr->out_nodes.begin();
                  nextOut != out_node_as_shared_ptr->out_nodes.end();) {
                 auto nextOutAsSharedPtr = nextOut->lock();
                 // if the outnode of an outnode of A is another outnode of A
-                if (n->find_node_ptr_in_out_nodes(nextOutAsSharedPtr)
-                    != n->out_nodes.end()) {
+                if (out_node_marks[nextOutAsSharedPtr->id] == mark) {
                     temp_path = get_union(n->path, nextOutAsSharedPtr->path);
 
                     if (out_node_as_shared_ptr->path.is_subpath(temp_path)) {
@@ -202,6 +224,15 @@ void KmerGraph::remove_shortcut_edges()
 
 void KmerGraph::check() const
 {
+    // position (from 1) of each node, by id, in the topological order given by
+    // sorted_nodes, so that checking that a neighbour occurs from a node onwards in
+    // this order is a single lookup. Nodes not in sorted_nodes keep position 0
+    std::vector<uint32_t> topological_rank(nodes.size(), 0);
+    uint32_t rank = 0;
+    for (const auto& node : sorted_nodes) {
+        topological_rank[node->id] = ++rank;
+    }
+
     // should not have any leaves, only nodes with degree 0 are start and end
     for (auto c = sorted_nodes.begin(); c != sorted_nodes.end(); ++c) {
         const bool is_start_node = (*c) == (*sorted_nodes.begin());
@@ -228,7 +259,7 @@ void KmerGraph::check() const
             }
 
             const bool neighbour_is_later_in_topological_order
-                = find(c, sorted_nodes.end(), dAsSharedPtr) != sorted_nodes.end();
+                = topological_rank[dAsSharedPtr->id] >= topological_rank[(*c)->id];
             if (!neighbour_is_later_in_topological_order) {
                 fatal_error("Error checking Kmer Graph: node ", dAsSharedPtr->id,
                     " does not occur later in sorted list than node ", (*c)->id,
@@ -353,8 +384,7 @@ void KmerGraph::load(const fs::path& filepath)
                         "num_nodes = ", num_nodes);
                 }
 
-                nodes.push_back(kmer_node);
-                sorted_nodes.insert(kmer_node);
+                index_node(kmer_node);
                 if (k == 0 and p.length() > 0) {
                     k = p.length();
                 }
@@ -435,14 +465,14 @@ void KmerGraph::load(const fs::path& filepath)
 
 uint32_t KmerGraph::min_path_length()
 {
-    // TODO: FIX THIS INNEFICIENCY I INTRODUCED
-    std::vector<KmerNodePtr> sorted_nodes(
-        this->sorted_nodes.begin(), this->sorted_nodes.end());
-
     if (shortest_path_length > 0) {
         return shortest_path_length;
     }
 
+    // TODO: FIX THIS INNEFICIENCY I INTRODUCED
+    std::vector<KmerNodePtr> sorted_nodes(
+        this->sorted_nodes.begin(), this->sorted_nodes.end());
+
     std::vector<uint32_t> len(
         sorted_nodes.size(), 0); // length of shortest path from node i to end of graph
     for (uint32_t j = sorted_nodes.size() - 1; j != 0; --j) {
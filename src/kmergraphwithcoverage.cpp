@@ -2,6 +2,7 @@
 #include <limits>
 #include <cstdlib> /* srand, rand */
 #include <cmath>
+#include <algorithm>
 
 #include <boost/math/distributions/negative_binomial.hpp>
 #include <boost/log/trivial.hpp>
@@ -36,23 +37,33 @@ void KmerGraphWithCoverage::set_binomial_parameter_p(const float e_rate)
     binomial_parameter_p = 1 / exp(e_rate * kmer_prg->k);
 }
 
+KmerGraphWithCoverage::SampleCoverage&
+KmerGraphWithCoverage::get_or_create_sample_coverage(uint32_t sample_id)
+{
+    auto& sample_coverage = this->sample_id_to_coverage[sample_id];
+    if (sample_coverage.empty()) {
+        sample_coverage.resize(this->kmer_prg->nodes.size());
+        sample_coverage.shrink_to_fit();
+    }
+    return sample_coverage;
+}
+
 void KmerGraphWithCoverage::increment_covg(
     uint32_t node_id, pandora::Strand strand, uint32_t sample_id)
 {
-    const bool sample_is_valid
-        = this->node_index_to_sample_coverage[node_id].size() > sample_id;
+    const bool sample_is_valid = sample_id < this->total_number_samples;
     if (!sample_is_valid) {
         fatal_error(
             "Error incrementing coverage: sample_id is invalid (", sample_id, ")");
     }
 
     // get a pointer to the value we want to increment
+    auto& sample_coverage = this->get_or_create_sample_coverage(sample_id);
     uint16_t* coverage_ptr = nullptr;
     if (strand == pandora::Strand::Forward) {
-        coverage_ptr = &(this->node_index_to_sample_coverage[node_id][sample_id].first);
+        coverage_ptr = &(sample_coverage[node_id].first);
     } else {
-        coverage_ptr
-            = &(this->node_index_to_sample_coverage[node_id][sample_id].second);
+        coverage_ptr = &(sample_coverage[node_id].second);
     }
 
     const bool safe_to_increase_covg { (*coverage_ptr) < UINT16_MAX };
@@ -64,32 +75,41 @@ void KmerGraphWithCoverage::increment_covg(
 uint32_t KmerGraphWithCoverage::get_covg(
     uint32_t node_id, pandora::Strand strand, uint32_t sample_id) const
 {
-
-    if (this->node_index_to_sample_coverage[node_id].size() <= sample_id)
+    const auto sample_coverage_it = this->sample_id_to_coverage.find(sample_id);
+    const bool sample_has_no_coverage
+        = sample_coverage_it == this->sample_id_to_coverage.end();
+    if (sample_has_no_coverage)
         return 0;
 
     if (strand == pandora::Strand::Forward) {
-        return (uint32_t)(
-            this->node_index_to_sample_coverage[node_id][sample_id].first);
+        return (uint32_t)(sample_coverage_it->second[node_id].first);
     } else {
-        return (uint32_t)(
-            this->node_index_to_sample_coverage[node_id][sample_id].second);
+        return (uint32_t)(sample_coverage_it->second[node_id].second);
     }
 }
 
 void KmerGraphWithCoverage::set_covg(
     uint32_t node_id, uint16_t value, pandora::Strand strand, uint32_t sample_id)
 {
-    const bool sample_is_valid
-        = this->node_index_to_sample_coverage[node_id].size() > sample_id;
+    const bool sample_is_valid = sample_id < this->total_number_samples;
     if (!sample_is_valid) {
         fatal_error("Error setting coverage: sample_id is invalid (", sample_id, ")");
     }
 
+    // setting a zero coverage on a sample with no coverage is a no-op, so that
+    // samples only get a coverage block when they do have some coverage
+    const bool sample_has_no_coverage
+        = this->sample_id_to_coverage.find(sample_id)
+        == this->sample_id_to_coverage.end();
+    if (value == 0 and sample_has_no_coverage) {
+        return;
+    }
+
+    auto& sample_coverage = this->get_or_create_sample_coverage(sample_id);
     if (strand == pandora::Strand::Forward) {
-        this->node_index_to_sample_coverage[node_id][sample_id].first = value;
+        sample_coverage[node_id].first = value;
     } else {
-        this->node_index_to_sample_coverage[node_id][sample_id].second = value;
+        sample_coverage[node_id].second = value;
     }
 }
 
@@ -231,9 +251,6 @@ float KmerGraphWithCoverage::find_max_path(std::vector<KmerNodePtr>& maxpath,
     const std::string& prob_model, const uint32_t& max_num_kmers_to_average,
     const uint32_t& sample_id)
 {
-    // TODO: FIX THIS INNEFICIENCY I INTRODUCED
-    const std::vector<KmerNodePtr> sorted_nodes(
-        this->kmer_prg->sorted_nodes.begin(), this->kmer_prg->sorted_nodes.end());
     this->kmer_prg->check();
 
     // also check not all 0 covgs
@@ -241,6 +258,55 @@ float KmerGraphWithCoverage::find_max_path(std::vector<KmerNodePtr>& maxpath,
     if (coverages_all_zero)
         return std::numeric_limits<float>::lowest();
 
+    std::vector<float> node_log_probs(this->kmer_prg->nodes.size());
+    for (const auto& node : this->kmer_prg->nodes) {
+        node_log_probs[node->id] = get_prob(prob_model, node->id, sample_id);
+    }
+    find_max_path_given_log_probs(maxpath, node_log_probs, max_num_kmers_to_average);
+
+    return prob_path(maxpath, sample_id, prob_model);
+}
+
+float KmerGraphWithCoverage::find_max_path_from_votes(std::vector<KmerNodePtr>& maxpath,
+    const std::vector<uint32_t>& node_votes, const uint32_t& num_reads,
+    const uint32_t& max_num_kmers_to_average) const
+{
+    this->kmer_prg->check();
+
+    const bool all_votes_are_zero = std::all_of(node_votes.begin(), node_votes.end(),
+        [](const uint32_t votes) { return votes == 0; });
+    if (all_votes_are_zero)
+        return std::numeric_limits<float>::lowest();
+
+    const bool reads_were_mapped_to_this_kmer_graph = num_reads != 0;
+    if (!reads_were_mapped_to_this_kmer_graph) {
+        fatal_error(
+            "Impossible to compute lin_prob, no reads were mapped to this kmer graph");
+    }
+
+    // a vote is one forward and one reverse coverage, each capped as the coverages are
+    std::vector<float> node_log_probs(this->kmer_prg->nodes.size());
+    for (const auto& node : this->kmer_prg->nodes) {
+        const uint32_t votes = std::min(node_votes[node->id], (uint32_t)UINT16_MAX);
+        node_log_probs[node->id] = log(float(2 * votes) / num_reads);
+    }
+    find_max_path_given_log_probs(maxpath, node_log_probs, max_num_kmers_to_average);
+
+    float return_prob_path = 0;
+    for (const auto& node : maxpath) {
+        return_prob_path += node_log_probs[node->id];
+    }
+    return normalise_by_path_length(maxpath, return_prob_path);
+}
+
+void KmerGraphWithCoverage::find_max_path_given_log_probs(
+    std::vector<KmerNodePtr>& maxpath, const std::vector<float>& node_log_probs,
+    const uint32_t& max_num_kmers_to_average) const
+{
+    // TODO: FIX THIS INNEFICIENCY I INTRODUCED
+    const std::vector<KmerNodePtr> sorted_nodes(
+        this->kmer_prg->sorted_nodes.begin(), this->kmer_prg->sorted_nodes.end());
+
     // create vectors to hold the intermediate values
     std::vector<float> max_sum_of_log_probs_from_node(sorted_nodes.size(), 0);
     std::vector<uint32_t> length_of_maxpath_from_node(sorted_nodes.size(), 0);
@@ -274,7 +340,7 @@ float KmerGraphWithCoverage::find_max_path(std::vector<KmerNodePtr>& maxpath,
             if (is_terminus_and_most_likely or avg_log_likelihood_is_most_likely
                 or (avg_log_likelihood_is_close_to_most_likely and is_longer_path)) {
                 max_sum_of_log_probs_from_node[current_node->id]
-                    = get_prob(prob_model, current_node->id, sample_id)
+                    = node_log_probs[current_node->id]
                     + max_sum_of_log_probs_from_node[considered_outnode->id];
                 length_of_maxpath_from_node[current_node->id]
                     = 1 + length_of_maxpath_from_node[considered_outnode->id];
@@ -287,7 +353,7 @@ float KmerGraphWithCoverage::find_max_path(std::vector<KmerNodePtr>& maxpath,
                         prev_node = prev_node_along_maxpath[prev_node];
                     }
                     max_sum_of_log_probs_from_node[current_node->id]
-                        -= get_prob(prob_model, sorted_nodes[prev_node]->id, sample_id);
+                        -= node_log_probs[sorted_nodes[prev_node]->id];
                     length_of_maxpath_from_node[current_node->id] -= 1;
 
                     // this remains as an assert, as it is a code check
@@ -323,8 +389,6 @@ float KmerGraphWithCoverage::find_max_path(std::vector<KmerNodePtr>& maxpath,
     if (!path_was_found_through_the_kmer_PRG) {
         fatal_error("Error when finding max path: found no path through kmer prg");
     }
-
-    return prob_path(maxpath, sample_id, prob_model);
 }
 
 std::vector<std::vector<KmerNodePtr>> KmerGraphWithCoverage::get_random_paths(
@@ -367,6 +431,12 @@ float KmerGraphWithCoverage::prob_path(const std::vector<KmerNodePtr>& kpath,
     for (uint32_t i = 0; i != kpath.size(); ++i) {
         return_prob_path += get_prob(prob_model, kpath[i]->id, sample_id);
     }
+    return normalise_by_path_length(kpath, return_prob_path);
+}
+
+float KmerGraphWithCoverage::normalise_by_path_length(
+    const std::vector<KmerNodePtr>& kpath, const float sum_of_log_probs)
+{
     uint32_t len = kpath.size();
     if (kpath[0]->path.length() == 0) {
         len -= 1;
@@ -377,7 +447,7 @@ float KmerGraphWithCoverage::prob_path(const std::vector<KmerNodePtr>& kpath,
     if (len == 0) {
         len = 1;
     }
-    return return_prob_path / len;
+    return sum_of_log_probs / len;
 }
 
 void KmerGraphWithCoverage::save_covg_dist(const std::string& filepath)
@@ -388,13 +458,10 @@ void KmerGraphWithCoverage::save_covg_dist(const std::string& filepath)
     for (const auto& kmer_node_ptr : kmer_prg->nodes) {
         const KmerNode& kmer_node = *kmer_node_ptr;
 
-        uint32_t sample_id = 0;
-        for (const auto& sample_coverage :
-            node_index_to_sample_coverage[kmer_node.id]) {
-            handle << kmer_node.id << " " << sample_id << " " << sample_coverage.first
-                   << " " << sample_coverage.second;
-
-            sample_id++;
+        for (uint32_t sample_id = 0; sample_id < total_number_samples; ++sample_id) {
+            handle << kmer_node.id << " " << sample_id << " "
+                   << get_forward_covg(kmer_node.id, sample_id) << " "
+                   << get_reverse_covg(kmer_node.id, sample_id);
         }
     }
     handle.close();
@@ -506,8 +573,7 @@ void KmerGraphWithCoverage::load(const std::string& filepath)
                         ", ", "num_nodes = ", num_nodes);
                 }
 
-                kmer_prg->nodes.push_back(n);
-                kmer_prg->sorted_nodes.insert(n);
+                kmer_prg->index_node(n);
                 if (kmer_prg->k == 0 and p.length() > 0) {
                     kmer_prg->k = p.length();
                 }
@@ -3,12 +3,14 @@
 #include <algorithm>
 #include <cstdlib>
 #include <utility>
+#include <limits>
 
 #include <boost/log/trivial.hpp>
 
 #include "minimizer.h"
 #include "localPRG.h"
 #include "inthash.h"
+#include "syncmer.h"
 #include "utils.h"
 #include "fastaq.h"
 #include "Maths.h"
@@ -18,6 +20,8 @@ bool LocalPRG::do_path_memoization_in_nodes_along_path_method = false;
 LocalPRG::LocalPRG(uint32_t id, const std::string& name, const std::string& seq)
     : next_id(0)
     , buff(" ")
+    , seq_length(seq.size())
+    , seq_is_released(false)
     , next_site(5)
     , id(id)
     , name(name)
@@ -47,17 +51,82 @@ bool LocalPRG::isalpha_string(const std::string& s) const
     return true;
 }
 
+LocalPRG::SiteMarkerIndex::SiteMarkerIndex(const std::string& seq)
+    : non_alpha_prefix_count(seq.size() + 1, 0)
+{
+    for (uint32_t pos = 0; pos < seq.size(); ++pos) {
+        non_alpha_prefix_count[pos + 1] = non_alpha_prefix_count[pos]
+            + (isalpha(static_cast<unsigned char>(seq[pos])) == 0);
+    }
+
+    // a marker is a space, the decimal site number and another space. Markers can
+    // share their flanking spaces (e.g. " 7  6 "), so every space is a candidate start
+    for (uint32_t pos = 0; pos < seq.size(); ++pos) {
+        if (seq[pos] != ' ') {
+            continue;
+        }
+        uint32_t end = pos + 1;
+        uint64_t site = 0;
+        while (end < seq.size() and isdigit(static_cast<unsigned char>(seq[end]))
+            and site <= std::numeric_limits<uint32_t>::max()) {
+            site = site * 10 + (seq[end] - '0');
+            ++end;
+        }
+        const uint32_t number_of_digits = end - pos - 1;
+        const bool is_marker = number_of_digits > 0 and end < seq.size()
+            and seq[end] == ' ' and site <= std::numeric_limits<uint32_t>::max()
+            and (seq[pos + 1] != '0' or number_of_digits == 1);
+        if (is_marker) {
+            site_to_marker_starts[site].push_back(pos);
+        }
+    }
+}
+
+std::string::size_type LocalPRG::SiteMarkerIndex::find(
+    const uint32_t site, const std::string::size_type from) const
+{
+    const auto site_it = site_to_marker_starts.find(site);
+    if (site_it == site_to_marker_starts.end()) {
+        return std::string::npos;
+    }
+    const auto& marker_starts = site_it->second;
+    const auto marker_it
+        = std::lower_bound(marker_starts.begin(), marker_starts.end(), from);
+    if (marker_it == marker_starts.end()) {
+        return std::string::npos;
+    }
+    return *marker_it;
+}
+
+bool LocalPRG::SiteMarkerIndex::is_alpha(const Interval& interval) const
+{
+    const uint32_t seq_size = non_alpha_prefix_count.size() - 1;
+    const uint32_t start = std::min(interval.start, seq_size);
+    const uint32_t end = std::min(interval.get_end(), seq_size);
+    return non_alpha_prefix_count[end] == non_alpha_prefix_count[start];
+}
+
+void LocalPRG::release_seq()
+{
+    std::string().swap(seq);
+    seq_is_released = true;
+}
+
 std::string LocalPRG::string_along_path(const prg::Path& p) const
 {
     const bool path_is_inside_the_PRG
-        = (p.get_start() <= seq.length()) && (p.get_end() <= seq.length());
+        = (p.get_start() <= seq_length) && (p.get_end() <= seq_length);
     if (!path_is_inside_the_PRG) {
         fatal_error(
             "Error getting sequence along PRG path: path goes beyond PRG limits");
     }
     std::string s;
-    for (const auto& it : p) {
-        s += seq.substr(it.start, it.length);
+    if (seq_is_released) {
+        s = string_along_path_from_nodes(p);
+    } else {
+        for (const auto& it : p) {
+            s += seq.substr(it.start, it.length);
+        }
     }
 
     const bool sequence_and_path_have_the_same_length = s.length() == p.length();
@@ -68,11 +137,36 @@ std::string LocalPRG::string_along_path(const prg::Path& p) const
     return s;
 }
 
+std::string LocalPRG::string_along_path_from_nodes(const prg::Path& p) const
+{
+    std::string s;
+    std::vector<size_t> overlaps;
+    for (const auto& interval : p) {
+        if (interval.length == 0) {
+            continue;
+        }
+        // zero-length nodes are not in the interval tree, so this is the only node
+        // containing the start of the interval
+        overlaps.clear();
+        prg.intervalTree.overlap(interval.start, interval.start + 1, overlaps);
+        const bool interval_is_inside_a_node = !overlaps.empty()
+            and interval.get_end()
+                <= prg.intervalTree.data(overlaps[0])->pos.get_end();
+        if (!interval_is_inside_a_node) {
+            fatal_error("Error getting sequence along PRG path: interval ", interval,
+                " is not inside a node of ", name);
+        }
+        const auto& node = prg.intervalTree.data(overlaps[0]);
+        node->seq.append_to(s, interval.start - node->pos.start, interval.length);
+    }
+    return s;
+}
+
 std::string LocalPRG::string_along_path(const std::vector<LocalNodePtr>& p)
 {
     std::string s;
     for (const auto& n : p) {
-        s += n->seq;
+        n->seq.append_to(s);
     }
     return s;
 }
@@ -196,6 +290,12 @@ void LocalPRG::check_if_vector_of_subintervals_is_consistent_with_envelopping_in
  2385) = the rest of the string -> AGGAACGATATCTTTC...
  */
 std::vector<Interval> LocalPRG::split_by_site(const Interval& i) const
+{
+    return split_by_site(i, SiteMarkerIndex(seq));
+}
+
+std::vector<Interval> LocalPRG::split_by_site(
+    const Interval& i, const SiteMarkerIndex& site_markers) const
 {
     // Splits interval by next_site based on substring of seq in the interval
     // Split first by var site
@@ -203,7 +303,7 @@ std::vector<Interval> LocalPRG::split_by_site(const Interval& i) const
     v.reserve(4);
     std::string::size_type k = i.start;
     std::string d = buff + std::to_string(next_site) + buff;
-    std::string::size_type j = seq.find(d, k);
+    std::string::size_type j = site_markers.find(next_site, k);
     while (j != std::string::npos
         and j + d.size()
             <= i.get_end()) { // splits the interval into the start of alleles and their
@@ -213,14 +313,14 @@ std::vector<Interval> LocalPRG::split_by_site(const Interval& i) const
                               // the site)
         v.emplace_back(Interval(k, j));
         k = j + d.size();
-        j = seq.find(d, k);
+        j = site_markers.find(next_site, k);
     }
 
     if (j != std::string::npos and j < i.get_end() and j + d.size() > i.get_end()) {
         v.emplace_back(Interval(k, j));
     } else if (j != std::string::npos and j + d.size() == i.get_end()) {
         v.emplace_back(Interval(k, j));
-        if (seq.find(buff, j + d.size()) == j + d.size()) {
+        if (seq.compare(j + d.size(), buff.size(), buff) == 0) {
             v.emplace_back(Interval(j + d.size(), j + d.size()));
         }
     } else { // add the last interval to v
@@ -237,20 +337,21 @@ std::vector<Interval> LocalPRG::split_by_site(const Interval& i) const
     d = buff + std::to_string(next_site + 1) + buff;
     for (uint32_t l = 0; l != v.size(); ++l) {
         k = v[l].start; // start of allele interval
-        j = seq.find(d, k); // end of allele interval
+        j = site_markers.find(next_site + 1, k); // end of allele interval
         while (j != std::string::npos
             and j + d.size() <= v[l].get_end()) { // check if the allele interval [k,j)
                                                   // is inside the variant site interval
             w.emplace_back(Interval(k, j)); // add the allele interval
             k = j + d.size(); // go to the next start of allele interval
-            j = seq.find(d, k); // go to the next end of allele interval
+            j = site_markers.find(
+                next_site + 1, k); // go to the next end of allele interval
         }
         if (j != std::string::npos and j < v[l].get_end()
             and j + d.size() > v[l].get_end()) {
             w.emplace_back(Interval(k, j));
         } else if (j != std::string::npos and j + d.size() == v[l].get_end()) {
             w.emplace_back(Interval(k, j));
-            if (seq.find(buff, j + d.size()) == j + d.size()) {
+            if (seq.compare(j + d.size(), buff.size(), buff) == 0) {
                 v.emplace_back(Interval(j + d.size(), j + d.size()));
             }
         } else { // add the last remaining interval
@@ -278,10 +379,16 @@ std::vector<Interval> LocalPRG::split_by_site(const Interval& i) const
     return w;
 }
 
+std::vector<uint32_t> LocalPRG::build_graph(
+    const Interval& i, const std::vector<uint32_t>& from_ids, uint32_t current_level)
+{
+    return build_graph(i, from_ids, SiteMarkerIndex(seq), current_level);
+}
+
 std::vector<uint32_t> // builds the graph based on the given interval - RETURNS THE SINK
                       // NODE AFTER BUILDING THE GRAPH
-LocalPRG::build_graph(
-    const Interval& i, const std::vector<uint32_t>& from_ids, uint32_t current_level)
+LocalPRG::build_graph(const Interval& i, const std::vector<uint32_t>& from_ids,
+    const SiteMarkerIndex& site_markers, uint32_t current_level)
 { // i: the interval from where to build the graph; from_ids: the sources from
     // we will return the ids on the ends of any stretches of graph added
     std::vector<uint32_t>
@@ -293,28 +400,31 @@ LocalPRG::build_graph(
     // end
     uint32_t start_id = next_id;
 
-    // add nodes
-    std::string s = seq.substr(
-        i.start, i.length); // gets the whole PRG string associated with this interval
-    if (isalpha_string(
-            s)) // should return true for empty string too - If s does not contain
-                // variation, then it wont have spaces, and this will return false. If
-                // it contains variations, then it will have space and will return true.
-                // Basically the question is: does s contains variation?
-    { // s does not contain variations
-        prg.add_node(next_id, s, i);
-        // add edges from previous part of graph to start of this interval
-        for (uint32_t j = 0; j != from_ids.size(); j++) {
-            prg.add_edge(from_ids[j], next_id);
+    // the rest of the PRG after each site is joined in this loop rather than by a
+    // recursive call, so the recursion only goes as deep as the sites are nested
+    Interval interval = i;
+    std::vector<uint32_t> previous_ids = from_ids;
+    while (true) {
+        // should return true for empty interval too - does the interval contain
+        // variation?
+        if (site_markers.is_alpha(interval)) { // interval does not contain variations
+            prg.add_node(
+                next_id, seq.substr(interval.start, interval.length), interval);
+            // add edges from previous part of graph to start of this interval
+            for (const auto& previous_id : previous_ids) {
+                prg.add_edge(previous_id, next_id);
+            }
+            end_ids.push_back(next_id);
+            next_id++;
+            break;
         }
-        end_ids.push_back(next_id);
-        next_id++;
-    } else { // s contains variation
-        // split by next var site
-        std::vector<Interval> v
-            = split_by_site(i); // should have length at least 4 //Split the interval
-                                // first into the invariant region coming before it, all
-                                // its alleles and then the rest of the PRG.
+
+        // interval contains variation, split by next var site
+        std::vector<Interval> v = split_by_site(
+            interval, site_markers); // should have length at least 4 //Split the
+                                     // interval first into the invariant region coming
+                                     // before it, all its alleles and then the rest of
+                                     // the PRG.
         if (v.size() < (uint32_t)4) {
             fatal_error(
                 "In conversion from linear localPRG string to graph, splitting the "
@@ -329,10 +439,8 @@ LocalPRG::build_graph(
         next_site += 2; // update next site
         // add first interval (should be the invariable seq, and thus composed only by
         // alpha chars)
-        s = seq.substr(
-            v[0].start, v[0].length); // gets the sequence of the invariable part
-        if (!(isalpha_string(
-                s))) { // verify that the invariable part is indeed invariable
+        if (!site_markers.is_alpha(
+                v[0])) { // verify that the invariable part is indeed invariable
             fatal_error(
                 "In conversion from linear localPRG string to graph, splitting the "
                 "string by "
@@ -346,11 +454,11 @@ LocalPRG::build_graph(
                 "var site: ",
                 v[0]);
         }
-        prg.add_node(
-            next_id, s, v[0]); // adds the invariable part as a node in the graph
+        prg.add_node(next_id, seq.substr(v[0].start, v[0].length),
+            v[0]); // adds the invariable part as a node in the graph
         // add edges from previous PRG to the start of this PRG
-        for (uint32_t j = 0; j != from_ids.size(); j++) {
-            prg.add_edge(from_ids[j], next_id);
+        for (const auto& previous_id : previous_ids) {
+            prg.add_edge(previous_id, next_id);
         }
 
         std::vector<uint32_t> mid_ids; // will denote the id of the source node
@@ -359,14 +467,16 @@ LocalPRG::build_graph(
         next_id++;
         // add (recurring as necessary) middle intervals //RECUSIVELY BUILDS THE GRAPH
         // FOR EACH ALLELE AND ADD THEM HERE.
+        previous_ids.clear();
         for (uint32_t j = 1; j != v.size() - 1; j++) {
-            std::vector<uint32_t> w = build_graph(v[j], mid_ids, current_level + 1);
-            end_ids.insert(
-                end_ids.end(), w.begin(), w.end()); // add the leaves from this internal
-                                                    // graph to the set of all leaves
+            std::vector<uint32_t> w
+                = build_graph(v[j], mid_ids, site_markers, current_level + 1);
+            previous_ids.insert(previous_ids.end(), w.begin(),
+                w.end()); // add the leaves from this internal graph to the set of all
+                          // leaves
         }
         // join all leaves into the last node of v, which will be the rest of the PRG
-        end_ids = build_graph(v.back(), end_ids, current_level);
+        interval = v.back();
     }
     if (start_id == 0) {
         const bool graph_has_a_sink_node = end_ids.size() == 1;
@@ -566,8 +676,7 @@ void LocalPRG::minimizer_sketch(const std::shared_ptr<Index>& index, const uint3
                         kn = kmer_prg.add_node_with_kh(
                             kmer_path, std::min(kh.first, kh.second), num_AT);
 
-// TODO: name these criticals
-#pragma omp critical
+#pragma omp critical(index)
                         { // and now to the index
                             index->add_record(std::min(kh.first, kh.second), id,
                                 kmer_path, kn->id, (kh.first <= kh.second));
@@ -628,8 +737,7 @@ void LocalPRG::minimizer_sketch(const std::shared_ptr<Index>& index, const uint3
                     new_kn = kmer_prg.add_node_with_kh(
                         *(v.back()), std::min(kh.first, kh.second), num_AT);
 
-// TODO: name these criticals
-#pragma omp critical
+#pragma omp critical(index)
                     {
                         index->add_record(std::min(kh.first, kh.second), id,
                             *(v.back()), new_kn->id, (kh.first <= kh.second));
@@ -679,8 +787,7 @@ void LocalPRG::minimizer_sketch(const std::shared_ptr<Index>& index, const uint3
                             new_kn = kmer_prg.add_node_with_kh(
                                 *(v[j]), std::min(kh.first, kh.second), num_AT);
 
-// TODO: name these criticals
-#pragma omp critical
+#pragma omp critical(index)
                             {
                                 index->add_record(std::min(kh.first, kh.second), id,
                                     *(v[j]), new_kn->id, (kh.first <= kh.second));
@@ -760,6 +867,159 @@ void LocalPRG::minimizer_sketch(const std::shared_ptr<Index>& index, const uint3
     kmer_prg.check();
 }
 
+void LocalPRG::syncmer_sketch(const std::shared_ptr<Index>& index, const uint32_t k,
+    const uint32_t s, double percentageDone)
+{
+    if (percentageDone >= 0)
+        BOOST_LOG_TRIVIAL(info)
+            << "Sketch PRG " << name << " which has " << prg.nodes.size() << " nodes ("
+            << percentageDone << "% done) with syncmers";
+    else
+        BOOST_LOG_TRIVIAL(info) << "Sketch PRG " << name << " which has "
+                                << prg.nodes.size() << " nodes with syncmers";
+
+    // clean up after any previous runs
+    // although note we can't clear the index because it is also added to by other
+    // LocalPRGs
+    kmer_prg.clear();
+
+    // declare variables
+    std::deque<KmerNodePtr> end_leaves;
+    // k-mer paths to check, each with the last syncmer found before it
+    std::deque<std::pair<KmerNodePtr, PathPtr>> kmer_paths_to_check;
+    // paths already followed from each syncmer, as branches of a bubble without
+    // syncmers reach the same k-mers after it
+    std::set<std::pair<uint32_t, prg::Path>> kmer_paths_checked;
+    std::deque<Interval> d;
+    prg::Path kmer_path;
+    std::string kmer;
+    std::pair<uint64_t, uint64_t> kh;
+    KmerHash hash;
+    uint32_t num_kmers_added = 0;
+    KmerNodePtr kn;
+    std::vector<LocalNodePtr> n;
+    size_t num_AT = 0;
+    const uint32_t prg_end = (--(prg.nodes.end()))->second->pos.get_end();
+
+    // create a null start node in the kmer graph
+    d = { Interval(0, 0) };
+    kmer_path.initialize(d); // initializes this path with the null start
+    const KmerNodePtr start_kn = kmer_prg.add_node(kmer_path);
+    num_kmers_added += 1;
+
+    // if this is a null prg, return the null kmergraph
+    if (prg.nodes.size() == 1 and prg.nodes[0]->pos.length < k) {
+        return;
+    }
+
+    // the first k-mers are all the walks of k bases from the start of the prg
+    std::vector<PathPtr> walk_paths = prg.walk(prg.nodes.begin()->second->id, 0, k);
+    if (walk_paths.empty()) {
+        return;
+    }
+    for (const auto& walk_path : walk_paths) {
+        // a k-mer at the end of the prg goes through the null nodes closing it, as
+        // shifted paths do
+        if (walk_path->get_end() == prg_end) {
+            n = nodes_along_path(*walk_path);
+            while (n.back()->outNodes.size() == 1
+                and n.back()->outNodes[0]->pos.length == 0) {
+                walk_path->add_end_interval(n.back()->outNodes[0]->pos);
+                n.push_back(n.back()->outNodes[0]);
+            }
+        }
+        kmer_paths_to_check.emplace_back(start_kn, walk_path);
+    }
+
+    // follow each path along the prg, shifting it by one base at a time, until the next
+    // syncmer. Syncmers already in the kmer graph only get a new in-edge: their own
+    // next syncmers have already been looked for
+    while (!kmer_paths_to_check.empty()) {
+        const KmerNodePtr previous_kn = kmer_paths_to_check.front().first;
+        const PathPtr path = kmer_paths_to_check.front().second;
+        kmer_paths_to_check.pop_front();
+        if (!kmer_paths_checked.emplace(previous_kn->id, *path).second) {
+            continue;
+        }
+
+        const bool path_has_k_bases = path->length() == k;
+        if (!path_has_k_bases) {
+            fatal_error("Error when sketching a local PRG with syncmers: path does not "
+                        "have k (",
+                k, ") bases");
+        }
+        kmer = string_along_path(*path);
+        kh = hash.kmerhash(kmer, k);
+        const bool forward_is_canonical = kh.first <= kh.second;
+        const std::vector<PathPtr> shift_paths = shift(*path);
+        const bool is_last_kmer_of_path_without_syncmer
+            = shift_paths.empty() and previous_kn == start_kn;
+
+        if (!is_open_syncmer(kmer, s, forward_is_canonical, hash)
+            and !is_last_kmer_of_path_without_syncmer) {
+            if (shift_paths.empty()) {
+                end_leaves.push_back(previous_kn);
+            }
+            for (const auto& shift_path : shift_paths) {
+                kmer_paths_to_check.emplace_back(previous_kn, shift_path);
+            }
+            continue;
+        }
+
+        KmerNodePtr dummyKmerHoldingKmerPath
+            = std::make_shared<KmerNode>(KmerNode(0, *path));
+        const auto found = kmer_prg.sorted_nodes.find(dummyKmerHoldingKmerPath);
+        if (found != kmer_prg.sorted_nodes.end()) {
+            kmer_prg.add_edge(previous_kn, *found);
+            continue;
+        }
+
+        num_AT = std::count(kmer.begin(), kmer.end(), 'A')
+            + std::count(kmer.begin(), kmer.end(), 'T');
+        kn = kmer_prg.add_node_with_kh(*path, std::min(kh.first, kh.second), num_AT);
+
+#pragma omp critical(index)
+        {
+            index->add_record(std::min(kh.first, kh.second), id, *path, kn->id,
+                forward_is_canonical);
+        }
+        num_kmers_added += 1;
+        kmer_prg.add_edge(previous_kn, kn);
+
+        if (shift_paths.empty()) {
+            end_leaves.push_back(kn);
+        }
+        for (const auto& shift_path : shift_paths) {
+            kmer_paths_to_check.emplace_back(kn, shift_path);
+        }
+    }
+
+    // create a null end node, and for each end leaf add an edge to this terminus
+    const bool kmer_graph_has_leaves = !end_leaves.empty();
+    if (!kmer_graph_has_leaves) {
+        fatal_error("Error when sketching a local PRG with syncmers: kmer graph does "
+                    "not have any leaves");
+    }
+
+    d = { Interval(prg_end, prg_end) };
+    kmer_path.initialize(d);
+    kn = kmer_prg.add_node(kmer_path);
+    num_kmers_added += 1;
+    for (uint32_t i = 0; i != end_leaves.size(); ++i) {
+        kmer_prg.add_edge(end_leaves[i], kn);
+    }
+
+    // check and return
+    const bool number_of_kmers_added_is_consistent
+        = kmer_prg.nodes.size() == num_kmers_added;
+    if (!number_of_kmers_added_is_consistent) {
+        fatal_error("Error when sketching a local PRG with syncmers: incorrect number "
+                    "of kmers added");
+    }
+    kmer_prg.remove_shortcut_edges();
+    kmer_prg.check();
+}
+
 bool intervals_overlap(const Interval& first, const Interval& second)
 {
     return ((first == second)
@@ -884,7 +1144,7 @@ std::vector<LocalNodePtr> LocalPRG::localnode_path_from_kmernode_path(
 
     // extend to end of graph if possible
     if (localnode_path.back()->id != prg.nodes.size() - 1) {
-        walk_paths = prg.walk_back(prg.nodes.size() - 1, seq.length(), w);
+        walk_paths = prg.walk_back(prg.nodes.size() - 1, seq_length, w);
         for (uint32_t i = 0; i != walk_paths.size(); ++i) {
             walk_path = nodes_along_path(*(walk_paths[i]));
 
@@ -1070,44 +1330,47 @@ void LocalPRG::write_aligned_path_to_fasta(const boost::filesystem::path& filepa
     handle.close();
 }
 
-// TODO: remove all the parameters from here:
-// TODO: we should return a VCF, instead of modifying one (avoid side effects)
-// TODO: a LocalPRG should know its reference path
-void LocalPRG::build_vcf_from_reference_path(
-    VCF& vcf, const std::vector<LocalNodePtr>& ref) const
+std::vector<VCFSite> LocalPRG::get_vcf_sites(const std::vector<LocalNodePtr>& ref) const
 {
-    BOOST_LOG_TRIVIAL(debug) << "Build VCF for prg " << name;
-
     const bool prg_is_empty = prg.nodes.empty();
     if (prg_is_empty) {
         fatal_error("Error when building VCF from reference path: PRG is empty");
     }
 
-    std::vector<LocalNodePtr> varpath;
-    varpath.reserve(100);
-    std::vector<LocalNodePtr> bottompath;
-    bottompath.reserve(100);
-    uint32_t ref_i = 0;
-    auto ref_length = string_along_path(ref).length();
+    std::vector<VCFSite> sites;
+    // simple case
+    if (ref.size() <= 1) {
+        return sites;
+    }
 
-    std::deque<std::vector<LocalNodePtr>> paths;
+    // ref_prefix_length[j] is the length of the sequence of the first j nodes of ref
+    std::vector<uint32_t> ref_prefix_length(ref.size() + 1, 0);
+    for (uint32_t j = 0; j != ref.size(); ++j) {
+        ref_prefix_length[j + 1] = ref_prefix_length[j] + ref[j]->seq.length();
+    }
+    const auto ref_length = ref_prefix_length.back();
 
-    std::vector<std::vector<LocalNodePtr>> alts;
-    alts.reserve(100);
+    // the alt paths are explored breadth first, as a tree in which each path only
+    // stores its last node and the index of the path it extends, so that extending a
+    // path does not copy it
+    struct AltPathEnd {
+        const LocalNode* node;
+        uint32_t previous; // index of the path this one extends, or no_previous
+    };
+    constexpr uint32_t no_previous = std::numeric_limits<uint32_t>::max();
+    std::vector<AltPathEnd> alt_path_ends;
+    std::vector<uint32_t> alts; // indexes in alt_path_ends of the complete alt paths
+    std::vector<const LocalNode*> alt_path;
+    std::vector<std::vector<const LocalNode*>> too_many_alts_paths;
 
     std::vector<uint32_t> level_start;
 
+    uint32_t ref_i = 0;
     int level = 0, max_level = 0;
-    uint32_t pos;
     std::string vartype = "GRAPHTYPE=SIMPLE";
     std::string ref_seq;
     std::string alt_seq;
 
-    // simple case
-    if (ref.size() == 1) {
-        return;
-    }
-
     while (ref_i < ref.size() - 1) {
         // first update the level we are at
         if (ref[ref_i]->outNodes.size() > 1) {
@@ -1135,65 +1398,60 @@ void LocalPRG::build_vcf_from_reference_path(
             }
 
             // define ref and pos
-            pos = 0;
+            const auto& site_start = ref[level_start.back()];
+            const uint32_t pos = ref_prefix_length[level_start.back() + 1];
             ref_seq = "";
-            for (uint32_t j = 0; j <= level_start.back(); ++j) {
-                pos += ref[j]->seq.length();
-            }
             for (uint32_t j = level_start.back() + 1; j <= ref_i; ++j) {
-                ref_seq += ref[j]->seq;
+                ref[j]->seq.append_to(ref_seq);
             }
+            const auto site_end_id = ref[ref_i]->outNodes[0]->id;
 
             // initialise alt paths
-            for (uint32_t n = 0; n < ref[level_start.back()]->outNodes.size(); ++n) {
-                if (ref[level_start.back()]->outNodes[n]
-                    != ref[level_start.back() + 1]) {
-                    varpath = { ref[level_start.back()]->outNodes[n] };
-                    paths.push_back(varpath);
+            alt_path_ends.clear();
+            for (uint32_t n = 0; n < site_start->outNodes.size(); ++n) {
+                if (site_start->outNodes[n] != ref[level_start.back() + 1]) {
+                    alt_path_ends.push_back(
+                        { site_start->outNodes[n].get(), no_previous });
                 }
             }
 
-            // extend alt paths to end of site
-            while (!paths.empty()) {
-                varpath = paths[0];
-                paths.pop_front();
-                if (varpath.back()->outNodes[0]->id == ref[ref_i]->outNodes[0]->id) {
-                    alts.push_back(varpath);
+            // extend alt paths to end of site - the paths still to extend are the ones
+            // from next_path on
+            for (uint32_t next_path = 0; next_path < alt_path_ends.size();) {
+                const uint32_t path_index = next_path++;
+                const auto* path_end = alt_path_ends[path_index].node;
+                if (path_end->outNodes[0]->id == site_end_id) {
+                    alts.push_back(path_index);
                 } else {
-                    for (uint32_t j = 0; j != varpath.back()->outNodes.size(); ++j) {
-                        paths.push_back(varpath);
-                        paths.back().push_back(varpath.back()->outNodes[j]);
+                    for (const auto& out_node : path_end->outNodes) {
+                        alt_path_ends.push_back({ out_node.get(), path_index });
                     }
                 }
 
                 // if have too many alts, just give bottom path and top path
-                if (paths.size() > 1000) {
-                    paths.clear();
+                if (alt_path_ends.size() - next_path > 1000) {
                     alts.clear();
-                    bottompath.push_back(ref[level_start.back()]->outNodes.back());
+                    std::vector<const LocalNode*> bottompath
+                        = { site_start->outNodes.back().get() };
                     while (!bottompath.back()->outNodes.empty()
-                        and bottompath.back()->outNodes[0]->id
-                            != ref[ref_i]->outNodes[0]->id) {
-                        bottompath.push_back(bottompath.back()->outNodes.back());
+                        and bottompath.back()->outNodes[0]->id != site_end_id) {
+                        bottompath.push_back(bottompath.back()->outNodes.back().get());
                     }
-                    alts.push_back(bottompath);
+                    too_many_alts_paths.push_back(bottompath);
 
-                    bottompath.clear();
-                    bottompath.push_back(ref[level_start.back()]->outNodes[0]);
+                    bottompath = { site_start->outNodes[0].get() };
                     while (!bottompath.back()->outNodes.empty()
-                        and bottompath.back()->outNodes[0]->id
-                            != ref[ref_i]->outNodes[0]->id) {
-                        bottompath.push_back(bottompath.back()->outNodes[0]);
+                        and bottompath.back()->outNodes[0]->id != site_end_id) {
+                        bottompath.push_back(bottompath.back()->outNodes[0].get());
                     }
-                    alts.push_back(bottompath);
-                    bottompath.clear();
+                    too_many_alts_paths.push_back(bottompath);
 
                     vartype = "GRAPHTYPE=TOO_MANY_ALTS";
                     break;
                 }
             }
 
-            // add sites to vcf
+            // add sites
             const bool record_sequence_is_valid = pos + ref_seq.length() <= ref_length;
             if (!record_sequence_is_valid) {
                 fatal_error("Error when building VCF from reference path: record "
@@ -1201,16 +1459,29 @@ void LocalPRG::build_vcf_from_reference_path(
                     pos + ref_seq.length(), ") overflows reference length (",
                     ref_length, ")");
             }
-            for (auto& alt : alts) {
-                for (auto& j : alt) {
-                    alt_seq += j->seq;
+            const auto add_site = [&](const std::vector<const LocalNode*>& alt) {
+                for (const auto& node : alt) {
+                    node->seq.append_to(alt_seq);
                 }
                 if (ref_seq != alt_seq) {
-                    vcf.add_record(name, pos, ref_seq, alt_seq, ".", vartype);
+                    sites.push_back({ pos, ref_seq, alt_seq, vartype });
                 }
                 alt_seq = "";
+            };
+            for (const auto& alt : alts) {
+                alt_path.clear();
+                for (uint32_t j = alt; j != no_previous;
+                     j = alt_path_ends[j].previous) {
+                    alt_path.push_back(alt_path_ends[j].node);
+                }
+                std::reverse(alt_path.begin(), alt_path.end());
+                add_site(alt_path);
+            }
+            for (const auto& alt : too_many_alts_paths) {
+                add_site(alt);
             }
             alts.clear();
+            too_many_alts_paths.clear();
 
             level_start.pop_back();
             if (level == 0) {
@@ -1226,6 +1497,93 @@ void LocalPRG::build_vcf_from_reference_path(
         }
         ref_i++;
     }
+    return sites;
+}
+
+// TODO: remove all the parameters from here:
+// TODO: we should return a VCF, instead of modifying one (avoid side effects)
+// TODO: a LocalPRG should know its reference path
+void LocalPRG::build_vcf_from_reference_path(
+    VCF& vcf, const std::vector<LocalNodePtr>& ref) const
+{
+    BOOST_LOG_TRIVIAL(debug) << "Build VCF for prg " << name;
+
+    // the sites of the reference path saved in the index are reused
+    std::vector<VCFSite> sites;
+    if (!load_saved_vcf_sites(ref, sites)) {
+        sites = get_vcf_sites(ref);
+    }
+    for (const auto& site : sites) {
+        vcf.add_record(name, site.pos, site.ref, site.alt, ".", site.graph_type);
+    }
+}
+
+void LocalPRG::save_vcf_sites(
+    const fs::path& filepath, const std::vector<LocalNodePtr>& ref) const
+{
+    fs::ofstream handle(filepath);
+    if (!handle.is_open()) {
+        fatal_error("Unable to open VCF sites file ", filepath);
+    }
+    // the reference path, then one site per line
+    for (uint32_t j = 0; j != ref.size(); ++j) {
+        handle << (j == 0 ? "" : " ") << ref[j]->id;
+    }
+    handle << std::endl;
+    for (const auto& site : get_vcf_sites(ref)) {
+        handle << site.pos << "\t" << site.ref << "\t" << site.alt << "\t"
+               << site.graph_type << std::endl;
+    }
+}
+
+bool LocalPRG::load_saved_vcf_sites(
+    const std::vector<LocalNodePtr>& ref, std::vector<VCFSite>& sites) const
+{
+    if (vcf_sites_file.empty() or ref.empty()) {
+        return false;
+    }
+    fs::ifstream handle(vcf_sites_file);
+    if (!handle.is_open()) {
+        fatal_error("Unable to open VCF sites file ", vcf_sites_file);
+    }
+
+    // the first line is the reference path the sites were saved along
+    std::string line;
+    if (!getline(handle, line)) {
+        return false;
+    }
+    std::istringstream path_stream(line);
+    uint32_t id;
+    uint32_t j = 0;
+    while (path_stream >> id) {
+        if (j == ref.size() or ref[j]->id != id) {
+            return false;
+        }
+        ++j;
+    }
+    if (j != ref.size()) {
+        return false;
+    }
+
+    while (getline(handle, line)) {
+        // ref or alt can be empty, so split, which drops empty fields, is not used
+        std::vector<std::string> site_fields;
+        std::istringstream line_stream(line);
+        std::string field;
+        while (getline(line_stream, field, '\t')) {
+            site_fields.push_back(field);
+        }
+        const bool line_is_consistent = site_fields.size() == 4
+            and !site_fields[0].empty()
+            and site_fields[0].find_first_not_of("0123456789") == std::string::npos;
+        if (!line_is_consistent) {
+            fatal_error("Error reading VCF sites file ", vcf_sites_file, ": line ",
+                line, " should have a position, a ref, an alt and a graph type");
+        }
+        sites.push_back({ (uint32_t)std::stoul(site_fields[0]), site_fields[1],
+            site_fields[2], site_fields[3] });
+    }
+    return true;
 }
 
 void LocalPRG::
@@ -1328,10 +1686,10 @@ void LocalPRG::
 
             // add new site to vcf
             for (uint32_t j = 1; j < refpath.size() - 1; ++j) {
-                ref += refpath[j]->seq;
+                refpath[j]->seq.append_to(ref);
             }
             for (uint32_t j = 1; j < samplepath.size() - 1; ++j) {
-                alt += samplepath[j]->seq;
+                samplepath[j]->seq.append_to(alt);
             }
 
             vcf.add_a_new_record_discovered_in_a_sample_and_genotype_it(
@@ -1592,14 +1950,37 @@ void LocalPRG::add_sample_covgs_to_vcf(VCF& vcf, const KmerGraphWithCoverage& kg
     BOOST_LOG_TRIVIAL(debug) << "Update VCF with sample covgs";
     vcf.sort_records();
 
-    std::vector<LocalNodePtr> alt_path;
+    std::vector<VCFRecord*> records;
+    records.reserve(vcf.get_records().size());
+    for (const auto& record : vcf.get_records()) {
+        records.push_back(record.get());
+    }
+    if (records.empty()) {
+        return;
+    }
+
+    auto sample_it = find(vcf.samples.begin(), vcf.samples.end(), sample_name);
+    auto sample_index = distance(vcf.samples.begin(), sample_it);
 
-    std::vector<KmerNodePtr> ref_kmer_path
-        = kmernode_path_from_localnode_path(ref_path);
+    const bool sample_is_valid = (sample_it != vcf.samples.end())
+        && ((uint)sample_index != vcf.samples.size());
+    if (!sample_is_valid) {
+        fatal_error("Error when adding sample coverages to VCF: sample is not valid");
+    }
 
+    add_sample_covgs_to_vcf_records(records, kg, ref_path,
+        kmernode_path_from_localnode_path(ref_path), sample_index, sample_id);
+}
+
+void LocalPRG::add_sample_covgs_to_vcf_records(const std::vector<VCFRecord*>& records,
+    const KmerGraphWithCoverage& kg, const std::vector<LocalNodePtr>& ref_path,
+    const std::vector<KmerNodePtr>& ref_kmer_path, const size_t sample_index,
+    const uint32_t& sample_id) const
+{
+    std::vector<LocalNodePtr> alt_path;
     std::vector<KmerNodePtr> alt_kmer_path;
 
-    for (auto& recordPointer : vcf.get_records()) {
+    for (auto* recordPointer : records) {
         auto& record = *recordPointer;
         // find corresponding ref kmers
         auto end_pos = record.get_ref_end_pos();
@@ -1635,18 +2016,6 @@ void LocalPRG::add_sample_covgs_to_vcf(VCF& vcf, const KmerGraphWithCoverage& kg
             all_reverse_coverages.push_back(alt_rev_covgs);
         }
 
-        // if sample has alt path, we have the kmer path for this, but otherwise we will
-        // need to work it out
-        auto sample_it = find(vcf.samples.begin(), vcf.samples.end(), sample_name);
-        auto sample_index = distance(vcf.samples.begin(), sample_it);
-
-        const bool sample_is_valid = (sample_it != vcf.samples.end())
-            && ((uint)sample_index != vcf.samples.size());
-        if (!sample_is_valid) {
-            fatal_error(
-                "Error when adding sample coverages to VCF: sample is not valid");
-        }
-
         record.sampleIndex_to_sampleInfo[sample_index].set_coverage_information(
             all_forward_coverages, all_reverse_coverages);
     }
@@ -1749,10 +2118,9 @@ std::vector<LocalNodePtr> LocalPRG::get_valid_vcf_reference(
     return reference_path;
 }
 
-void LocalPRG::add_variants_to_vcf(VCF& master_vcf, PanNodePtr pnode,
-    const std::string& vcf_ref, const std::vector<KmerNodePtr>& kmp,
-    const std::vector<LocalNodePtr>& lmp, const uint32_t& sample_id,
-    const std::string& sample_name)
+void LocalPRG::build_sample_vcf(VCF& vcf, PanNodePtr pnode, const std::string& vcf_ref,
+    const std::vector<KmerNodePtr>& kmp, const std::vector<LocalNodePtr>& lmp,
+    const uint32_t& sample_id, const std::string& sample_name)
 {
     auto reference_path = get_valid_vcf_reference(vcf_ref);
     if (reference_path.empty()) {
@@ -1761,14 +2129,22 @@ void LocalPRG::add_variants_to_vcf(VCF& master_vcf, PanNodePtr pnode,
         reference_path = lmp;
     }
 
-    VCF vcf(master_vcf.genotyping_options);
     build_vcf_from_reference_path(vcf, reference_path);
     add_new_records_and_genotype_to_vcf_using_max_likelihood_path_of_the_sample(
         vcf, reference_path, lmp, sample_name);
     add_sample_covgs_to_vcf(
         vcf, pnode->kmer_prg_with_coverage, reference_path, sample_name, sample_id);
-    vcf = vcf.merge_multi_allelic();
-    vcf = vcf.correct_dot_alleles(string_along_path(reference_path), name);
+    vcf.merge_multi_allelic_in_place();
+    vcf.correct_dot_alleles_in_place(string_along_path(reference_path), name);
+}
+
+void LocalPRG::add_variants_to_vcf(VCF& master_vcf, PanNodePtr pnode,
+    const std::string& vcf_ref, const std::vector<KmerNodePtr>& kmp,
+    const std::vector<LocalNodePtr>& lmp, const uint32_t& sample_id,
+    const std::string& sample_name)
+{
+    VCF vcf(master_vcf.genotyping_options);
+    build_sample_vcf(vcf, pnode, vcf_ref, kmp, lmp, sample_id, sample_name);
 #pragma omp critical(master_vcf)
     {
         master_vcf.append_vcf(vcf);
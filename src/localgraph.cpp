@@ -25,7 +25,7 @@ void LocalGraph::add_node(
         startIndexOfAllIntervals[pos.start] = n;
     } else {
         const bool node_with_same_id_seq_and_pos_already_added
-            = (it->second->seq == seq) && (it->second->pos == pos);
+            = (it->second->seq == PackedSequence(seq)) && (it->second->pos == pos);
         if (!node_with_same_id_seq_and_pos_already_added) {
             fatal_error("Error adding node to Local Graph: node with ID ", id,
                 " already exists in graph, but with different sequence or pos");
@@ -264,7 +264,8 @@ std::vector<LocalNodePtr> LocalGraph::nodes_along_string(
 
     // if there is only one node in PRG, simple case, do simple string compare
     if (nodes.size() == 1
-        and strcasecmp(query_string.c_str(), nodes.at(0)->seq.c_str()) == 0) {
+        and strcasecmp(query_string.c_str(), nodes.at(0)->seq.to_string().c_str())
+            == 0) {
         return { nodes.at(0) };
     }
 
@@ -274,13 +275,14 @@ std::vector<LocalNodePtr> LocalGraph::nodes_along_string(
         for (const auto& p : u) {
             candidate_string = "";
             for (const auto& s : p) {
-                candidate_string += s->seq;
+                s->seq.append_to(candidate_string);
             }
 
             for (uint32_t j = 0; j != p.back()->outNodes.size(); ++j) {
                 // if the start of query_string matches extended candidate_string, want
                 // to query candidate path extensions
-                auto comp_string = candidate_string + p.back()->outNodes[j]->seq;
+                auto comp_string = candidate_string;
+                p.back()->outNodes[j]->seq.append_to(comp_string);
                 auto comp_length = std::min(query_string.size(), comp_string.size());
                 if (strcasecmp(query_string.substr(0, comp_length).c_str(),
                         comp_string.substr(0, comp_length).c_str())
@@ -333,7 +335,7 @@ std::vector<LocalNodePtr> LocalGraph::nodes_along_string(
         for (const auto& p : w) {
             candidate_string = "";
             for (const auto& s : p) {
-                candidate_string += s->seq;
+                s->seq.append_to(candidate_string);
             }
             if (strcasecmp(query_string.c_str(), candidate_string.c_str()) == 0) {
                 return p;
@@ -15,12 +15,14 @@ void setup_map_subcommand(CLI::App& app)
         ->type_name("FILE");
 
     map_subcmd
-        ->add_option(
-            "<QUERY>", opt->readsfile, "Fast{a,q} file containing reads to quasi-map")
+        ->add_option("<QUERY>", opt->readsfiles,
+            "Fast{a,q} file(s) containing reads to quasi-map. Several files (e.g. "
+            "paired-end or multi-flowcell runs) are read one after the other. A file "
+            "whose name contains a comma must be the only file given")
         ->required()
         ->transform(make_absolute)
         ->check(CLI::ExistingFile.description(""))
-        ->type_name("FILE");
+        ->type_name("FILE...");
 
     map_subcmd
         ->add_option(
@@ -34,6 +36,13 @@ void setup_map_subcommand(CLI::App& app)
         ->capture_default_str()
         ->group("Indexing");
 
+    map_subcmd
+        ->add_option("--query-window", opt->query_window_size,
+            "Window size used to sketch reads (must be >=w). Larger values give a "
+            "sparser read sketch: faster mapping, lower sensitivity [default: w]")
+        ->type_name("INT")
+        ->group("Mapping");
+
     map_subcmd
         ->add_option("-o,--outdir", opt->outdir, "Directory to write output files to")
         ->type_name("DIR")
@@ -56,6 +65,14 @@ void setup_map_subcommand(CLI::App& app)
         ->check(CLI::ExistingFile.description(""))
         ->group("Input/Output");
 
+    description = "File with the names of the loci to restrict to, one per line. Only "
+                  "these loci are loaded from <TARGET> and searched for in the reads";
+    map_subcmd->add_option("--loci", opt->loci_file, description)
+        ->type_name("FILE")
+        ->transform(make_absolute)
+        ->check(CLI::ExistingFile.description(""))
+        ->group("Input/Output");
+
     map_subcmd
         ->add_option(
             "-e,--error-rate", opt->error_rate, "Estimated error rate for reads")
@@ -104,9 +121,15 @@ void setup_map_subcommand(CLI::App& app)
             "reads")
         ->group("Preset");
 
+    description = "Add a step to clean and detangle the pangraph";
+    auto* clean_opt = map_subcmd->add_flag("--clean", opt->clean, description)
+                          ->group("Filtering");
+
     map_subcmd
-        ->add_flag(
-            "--clean", opt->clean, "Add a step to clean and detangle the pangraph")
+        ->add_flag("--clean-by-component", opt->clean_by_component,
+            "Clean the connected components of the pangraph separately, in parallel. "
+            "Nodes created when detangling are then numbered component by component")
+        ->needs(clean_opt)
         ->group("Filtering");
 
     map_subcmd
@@ -120,6 +143,21 @@ void setup_map_subcommand(CLI::App& app)
         ->type_name("INT")
         ->group("Filtering");
 
+    description = "Deterministically subsample this fraction of the reads, based on "
+                  "a hash of their names";
+    map_subcmd->add_option("--subsample", opt->subsample_fraction, description)
+        ->capture_default_str()
+        ->check(CLI::Range(0.0, 1.0))
+        ->type_name("FLOAT")
+        ->group("Filtering");
+
+    description = "Stop reading reads once their bases cover the genome size this many "
+                  "times (0 to disable)";
+    map_subcmd->add_option("--target-covg", opt->target_covg, description)
+        ->capture_default_str()
+        ->type_name("INT")
+        ->group("Filtering");
+
     description = "Add extra step to carefully genotype sites.";
     auto* gt_opt = map_subcmd->add_flag("--genotype", opt->genotype, description)
                        ->group("Consensus/Variant Calling");
@@ -247,20 +285,34 @@ int pandora_map(MapOptions& opt)
         fs::create_directories(kmer_graphs_dir);
     }
 
+    std::unordered_set<std::string> loci_to_load;
+    if (!opt.loci_file.empty()) {
+        loci_to_load = load_loci_file(opt.loci_file);
+    }
+
     BOOST_LOG_TRIVIAL(info) << "Loading Index and LocalPRGs from file...";
-    auto index = std::make_shared<Index>();
-    index->load(opt.prgfile, opt.window_size, opt.kmer_size);
     std::vector<std::shared_ptr<LocalPRG>> prgs;
-    read_prg_file(prgs, opt.prgfile);
+    read_prg_file(prgs, opt.prgfile, 0, loci_to_load, true);
     load_PRG_kmergraphs(prgs, opt.window_size, opt.kmer_size, opt.prgfile);
+    std::unordered_set<uint32_t> prg_ids_to_load;
+    if (!loci_to_load.empty()) {
+        prg_ids_to_load = get_loaded_prg_ids(prgs);
+        if (prg_ids_to_load.empty()) {
+            fatal_error("None of the loci in ", opt.loci_file, " are in ", opt.prgfile);
+        }
+    }
+    auto index = std::make_shared<Index>();
+    index->load(opt.prgfile, opt.window_size, opt.kmer_size, prg_ids_to_load);
 
     BOOST_LOG_TRIVIAL(info)
         << "Constructing pangenome::Graph from read file (this will take a while)...";
     auto pangraph = std::make_shared<pangenome::Graph>();
-    uint32_t covg = pangraph_from_read_file(opt.readsfile.string(), pangraph, index,
+    const std::string reads_filepaths { join_read_filepaths(opt.readsfiles) };
+    uint32_t covg = pangraph_from_read_file(reads_filepaths, pangraph, index,
         prgs, opt.window_size, opt.kmer_size, opt.max_diff, opt.error_rate,
         opt.min_cluster_size, opt.genome_size, opt.illumina, opt.clean, opt.max_covg,
-        opt.threads);
+        opt.threads, opt.query_window_size, opt.subsample_fraction, opt.target_covg,
+        opt.clean_by_component);
 
     if (pangraph->nodes.empty()) {
         BOOST_LOG_TRIVIAL(info) << "Found non of the LocalPRGs in the reads.";
@@ -360,8 +412,22 @@ int pandora_map(MapOptions& opt)
         if (opt.output_vcf) {
             // TODO: this takes a lot of time and should be optimized, but it is
             // only called in this part, so maybe this should be low prioritized
-            prgs[pangraph_node->prg_id]->add_variants_to_vcf(
-                master_vcf, pangraph_node, vcf_ref, kmp, lmp);
+            VCF vcf(&genotyping_options);
+            prgs[pangraph_node->prg_id]->build_sample_vcf(
+                vcf, pangraph_node, vcf_ref, kmp, lmp);
+
+            // records of different loci never overlap, so each locus is genotyped
+            // here, in the same order as when genotyping the sorted master VCF. Both
+            // the consensus and the genotyped calls are kept in the records
+            if (opt.genotype) {
+                vcf.sort_records();
+                vcf.genotype(opt.local_genotype);
+            }
+
+#pragma omp critical(master_vcf)
+            {
+                master_vcf.append_vcf(vcf);
+            }
         }
     }
 
@@ -384,9 +450,6 @@ int pandora_map(MapOptions& opt)
     }
 
     if (opt.genotype) {
-        BOOST_LOG_TRIVIAL(info) << "Genotyping VCF...";
-        master_vcf.genotype(opt.local_genotype);
-        BOOST_LOG_TRIVIAL(info) << "Finished genotyping VCF";
         const auto gt_vcf_filepath { opt.outdir / "pandora_genotyped.vcf" };
         if (opt.snps_only) {
             master_vcf.save(gt_vcf_filepath, false, true, false, true, true, true, true,
@@ -397,7 +460,7 @@ int pandora_map(MapOptions& opt)
     }
 
     if (opt.output_mapped_read_fa) {
-        pangraph->save_mapped_read_strings(opt.readsfile, opt.outdir);
+        pangraph->save_mapped_read_strings(reads_filepaths, opt.outdir);
     }
 
     BOOST_LOG_TRIVIAL(info) << "Done!";
@@ -4,7 +4,9 @@
 #include <set>
 #include <utility>
 #include <vector>
+#include <algorithm>
 #include "utils.h"
+#include "noise_filtering.h"
 #include "pangenome/pangraph.h"
 #include "pangenome/pannode.h"
 #include "de_bruijn/graph.h"
@@ -449,11 +451,10 @@ void detangle_pangraph_with_debruijn_graph(
     }
 }
 
-void clean_pangraph_with_debruijn_graph(std::shared_ptr<pangenome::Graph> pangraph,
+namespace {
+void clean_component_with_debruijn_graph(std::shared_ptr<pangenome::Graph> pangraph,
     const uint_least32_t size, const uint_least32_t threshold, const bool illumina)
 {
-    BOOST_LOG_TRIVIAL(debug) << "Construct de Bruijn Graph from PanGraph with size "
-                             << (uint32_t)size;
     debruijn::Graph dbg(size);
     construct_debruijn_graph(pangraph, dbg);
 
@@ -470,6 +471,173 @@ void clean_pangraph_with_debruijn_graph(std::shared_ptr<pangenome::Graph> pangra
     detangle_pangraph_with_debruijn_graph(pangraph, dbg);
 }
 
+NodeId find_component_root(std::unordered_map<NodeId, NodeId>& parents, NodeId node_id)
+{
+    while (parents[node_id] != node_id) {
+        parents[node_id] = parents[parents[node_id]];
+        node_id = parents[node_id];
+    }
+    return node_id;
+}
+}
+
+PangraphComponents split_pangraph_into_components(
+    const std::shared_ptr<pangenome::Graph>& pangraph)
+{
+    // union-find of the nodes which appear together in a read
+    std::unordered_map<NodeId, NodeId> parents;
+    for (const auto& read_entry : pangraph->reads) {
+        const auto& read_nodes = read_entry.second->get_nodes();
+        if (read_nodes.empty()) {
+            continue;
+        }
+        const NodeId first_node_id = read_nodes[0].lock()->node_id;
+        parents.emplace(first_node_id, first_node_id);
+        for (const auto& node : read_nodes) {
+            const NodeId node_id = node.lock()->node_id;
+            parents.emplace(node_id, node_id);
+            const NodeId root = find_component_root(parents, node_id);
+            const NodeId first_node_root = find_component_root(parents, first_node_id);
+            if (root != first_node_root) {
+                parents[root] = first_node_root;
+            }
+        }
+    }
+
+    // components are numbered in the order of their first read, so that the same
+    // pangraph is always split the same way
+    PangraphComponents components;
+    std::unordered_map<NodeId, uint32_t> root_to_component;
+    for (const auto& read_entry : pangraph->reads) {
+        const auto& read_nodes = read_entry.second->get_nodes();
+        if (read_nodes.empty()) {
+            continue;
+        }
+        const NodeId root
+            = find_component_root(parents, read_nodes[0].lock()->node_id);
+        const auto component_it
+            = root_to_component.emplace(root, components.graphs.size()).first;
+        if (component_it->second == components.graphs.size()) {
+            components.graphs.push_back(std::make_shared<pangenome::Graph>());
+        }
+        components.read_id_to_component[read_entry.first] = component_it->second;
+        components.graphs[component_it->second]->reads[read_entry.first]
+            = read_entry.second;
+    }
+
+    // nodes without reads are not in any component
+    for (const auto& node_entry : pangraph->nodes) {
+        if (parents.find(node_entry.first) == parents.end()) {
+            continue;
+        }
+        const uint32_t component
+            = root_to_component.at(find_component_root(parents, node_entry.first));
+        components.node_id_to_component[node_entry.first] = component;
+        components.graphs[component]->nodes[node_entry.first] = node_entry.second;
+    }
+    return components;
+}
+
+void merge_pangraph_components(
+    std::shared_ptr<pangenome::Graph> pangraph, const PangraphComponents& components)
+{
+    // nodes created when detangling a component have ids local to that component, so
+    // they are given new ids of the pangraph, in the order of the components and in
+    // the order they were created in each component. This is done before removing
+    // nodes, so that, as when detangling, ids of removed nodes are not reused
+    for (const auto& component : components.graphs) {
+        std::vector<pangenome::NodePtr> created_nodes;
+        for (const auto& node_entry : component->nodes) {
+            const auto original_node_it = pangraph->nodes.find(node_entry.first);
+            const bool is_original_node = original_node_it != pangraph->nodes.end()
+                and original_node_it->second == node_entry.second;
+            if (!is_original_node) {
+                created_nodes.push_back(node_entry.second);
+            }
+        }
+        std::sort(created_nodes.begin(), created_nodes.end(),
+            [](const pangenome::NodePtr& lhs, const pangenome::NodePtr& rhs) {
+                return lhs->node_id < rhs->node_id;
+            });
+
+        for (const auto& created_node : created_nodes) {
+            const uint32_t node_id = pangraph->get_next_free_node_id();
+            auto node = std::make_shared<pangenome::Node>(created_node->prg, node_id,
+                created_node->kmer_prg_with_coverage.get_total_number_samples());
+            node->reads = created_node->reads;
+            node->covg = created_node->covg;
+            for (const auto& read : created_node->reads) {
+                auto& read_nodes = read->get_nodes();
+                for (uint32_t i = 0; i < read_nodes.size(); ++i) {
+                    if (read_nodes[i].lock() == created_node) {
+                        read->replace_node_with_iterator(read_nodes.begin() + i, node);
+                    }
+                }
+            }
+            pangraph->nodes[node_id] = node;
+        }
+    }
+
+    // the reads and nodes themselves are shared with the components, so only those
+    // removed from their component need to be removed from the pangraph
+    for (auto node_it = pangraph->nodes.begin(); node_it != pangraph->nodes.end();) {
+        const auto component_it
+            = components.node_id_to_component.find(node_it->first);
+        if (component_it == components.node_id_to_component.end()) {
+            ++node_it;
+            continue;
+        }
+        const auto& component_nodes = components.graphs[component_it->second]->nodes;
+        const auto component_node_it = component_nodes.find(node_it->first);
+        if (component_node_it == component_nodes.end()
+            or component_node_it->second != node_it->second) {
+            node_it = pangraph->nodes.erase(node_it);
+        } else {
+            ++node_it;
+        }
+    }
+    for (auto read_it = pangraph->reads.begin(); read_it != pangraph->reads.end();) {
+        const auto component_it
+            = components.read_id_to_component.find(read_it->first);
+        if (component_it != components.read_id_to_component.end()
+            and components.graphs[component_it->second]->reads.count(read_it->first)
+                == 0) {
+            read_it = pangraph->reads.erase(read_it);
+        } else {
+            ++read_it;
+        }
+    }
+}
+
+void clean_pangraph_with_debruijn_graph(std::shared_ptr<pangenome::Graph> pangraph,
+    const uint_least32_t size, const uint_least32_t threshold, const bool illumina,
+    const bool clean_by_component, const uint32_t threads)
+{
+    BOOST_LOG_TRIVIAL(debug) << "Construct de Bruijn Graph from PanGraph with size "
+                             << (uint32_t)size;
+    if (!clean_by_component) {
+        clean_component_with_debruijn_graph(pangraph, size, threshold, illumina);
+        return;
+    }
+
+    const PangraphComponents components = split_pangraph_into_components(pangraph);
+    if (components.graphs.size() <= 1) {
+        clean_component_with_debruijn_graph(pangraph, size, threshold, illumina);
+        return;
+    }
+
+    // reads and nodes of different components never interact when cleaning, so each
+    // component is cleaned on its own, in parallel
+    BOOST_LOG_TRIVIAL(debug) << "Clean the " << components.graphs.size()
+                             << " connected components of the pangraph";
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+    for (uint32_t i = 0; i < components.graphs.size(); ++i) {
+        clean_component_with_debruijn_graph(
+            components.graphs[i], size, threshold, illumina);
+    }
+    merge_pangraph_components(pangraph, components);
+}
+
 enum NodeDirection { forward, reverse };
 
 NodeDirection get_pangraph_node_direction(const debruijn::Node& debruijn_node)
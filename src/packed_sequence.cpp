@@ -0,0 +1,108 @@
+#include <algorithm>
+#include "packed_sequence.h"
+#include "fatal_error.h"
+
+namespace {
+constexpr uint32_t bases_per_word = 32;
+constexpr char code_to_base[4] = { 'A', 'C', 'G', 'T' };
+
+// 2-bit code of an upper-case ACGT, or 4 for any other character
+uint64_t base_to_code(const char base)
+{
+    switch (base) {
+    case 'A':
+        return 0;
+    case 'C':
+        return 1;
+    case 'G':
+        return 2;
+    case 'T':
+        return 3;
+    default:
+        return 4;
+    }
+}
+}
+
+PackedSequence::PackedSequence(const std::string& sequence)
+    : number_of_bases(sequence.size())
+    , packed_bases((sequence.size() + bases_per_word - 1) / bases_per_word, 0)
+{
+    for (uint32_t position = 0; position < number_of_bases; ++position) {
+        uint64_t code = base_to_code(sequence[position]);
+        if (code > 3) {
+            exceptions.emplace_back(position, sequence[position]);
+            code = 0;
+        }
+        packed_bases[position / bases_per_word]
+            |= code << (2 * (position % bases_per_word));
+    }
+}
+
+char PackedSequence::at(const uint32_t position) const
+{
+    if (position >= number_of_bases) {
+        fatal_error("Error getting base ", position, " of a packed sequence of length ",
+            number_of_bases);
+    }
+    if (!exceptions.empty()) {
+        const auto exception_it = std::lower_bound(exceptions.begin(), exceptions.end(),
+            std::make_pair(position, '\0'));
+        if (exception_it != exceptions.end() and exception_it->first == position) {
+            return exception_it->second;
+        }
+    }
+    const uint64_t word = packed_bases[position / bases_per_word];
+    return code_to_base[(word >> (2 * (position % bases_per_word))) & 3];
+}
+
+void PackedSequence::append_to(
+    std::string& s, const uint32_t start, uint32_t length) const
+{
+    if (start > number_of_bases) {
+        fatal_error("Error decoding packed sequence: start ", start,
+            " is after the end of the sequence (", number_of_bases, ")");
+    }
+    length = std::min(length, number_of_bases - start);
+    const auto offset = s.size();
+    s.resize(offset + length);
+    for (uint32_t i = 0; i < length; ++i) {
+        const uint32_t position = start + i;
+        const uint64_t word = packed_bases[position / bases_per_word];
+        s[offset + i] = code_to_base[(word >> (2 * (position % bases_per_word))) & 3];
+    }
+
+    // overwrite the placeholder bases of the exceptions in the decoded range
+    auto exception_it = std::lower_bound(
+        exceptions.begin(), exceptions.end(), std::make_pair(start, '\0'));
+    for (; exception_it != exceptions.end() and exception_it->first < start + length;
+         ++exception_it) {
+        s[offset + exception_it->first - start] = exception_it->second;
+    }
+}
+
+std::string PackedSequence::substr(const uint32_t start, const uint32_t length) const
+{
+    std::string s;
+    append_to(s, start, length);
+    return s;
+}
+
+std::string PackedSequence::to_string() const { return substr(); }
+
+bool PackedSequence::operator==(const PackedSequence& other) const
+{
+    return number_of_bases == other.number_of_bases
+        and packed_bases == other.packed_bases and exceptions == other.exceptions;
+}
+
+bool PackedSequence::operator!=(const PackedSequence& other) const
+{
+    return !(*this == other);
+}
+
+std::ostream& operator<<(std::ostream& out, const PackedSequence& sequence)
+{
+    out << sequence.to_string();
+    return out;
+}
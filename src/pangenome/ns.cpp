@@ -7,6 +7,7 @@ class Node;
 class Read;
 
 class Sample;
+class SamplePath;
 struct SamplePtrSorterBySampleId;
 
 class Graph;
@@ -218,6 +218,14 @@ void pangenome::Graph::remove_low_covg_nodes(const uint32_t& thresh)
     BOOST_LOG_TRIVIAL(debug) << "Pangraph now has " << nodes.size() << " nodes";
 }
 
+uint32_t pangenome::Graph::get_next_free_node_id()
+{
+    while (nodes.find(next_id) != nodes.end()) {
+        next_id++;
+    }
+    return next_id;
+}
+
 // Create a copy of the node with node_id and replace the old copy with
 // the new one in each of the reads in reads_along_tig (by looking for the context of
 // node_id)
@@ -231,15 +239,13 @@ void pangenome::Graph::split_node_by_reads(std::unordered_set<ReadPtr>& reads_al
 
     // replace the first instance of node_id which it finds on the read
     // (in the context of node_ids) with a new node
-    while (nodes.find(next_id) != nodes.end()) {
-        next_id++;
-    }
+    const uint32_t new_node_id = get_next_free_node_id();
 
     // define new node
-    NodePtr n = std::make_shared<Node>(nodes[node_id]->prg, next_id,
+    NodePtr n = std::make_shared<Node>(nodes[node_id]->prg, new_node_id,
         nodes[node_id]->kmer_prg_with_coverage.get_total_number_samples());
     n->covg -= 1;
-    nodes[next_id] = n;
+    nodes[new_node_id] = n;
 
     // switch old node to new node in reads
     std::unordered_multiset<ReadPtr>::iterator rit;
@@ -271,7 +277,7 @@ void pangenome::Graph::split_node_by_reads(std::unordered_set<ReadPtr>& reads_al
     // replace node in tig
     for (uint32_t i = 0; i < node_ids.size(); ++i) {
         if (node_ids[i] == node_id) {
-            node_ids[i] = next_id;
+            node_ids[i] = new_node_id;
             break;
         }
     }
@@ -404,10 +410,10 @@ std::vector<LocalNodePtr> pangenome::Graph::get_node_closest_vcf_reference(
     const Node& node, const uint32_t& w, const LocalPRG& prg,
     const uint32_t& max_num_kmers_to_average) const
 {
-    // TODO: check if this is correct
-    auto kmer_prg_with_coverage
-        = node.kmer_prg_with_coverage; // TODO: is this indeed an assignment op?
-    kmer_prg_with_coverage.zeroCoverages();
+    // count, for each kmer node, how many sample paths go through it
+    const auto& kmer_prg_with_coverage = node.kmer_prg_with_coverage;
+    const auto number_of_kmer_nodes = kmer_prg_with_coverage.kmer_prg->nodes.size();
+    std::vector<uint32_t> node_votes(number_of_kmer_nodes, 0);
 
     for (const auto& sample_entry : this->samples) {
         const auto& sample = sample_entry.second;
@@ -417,32 +423,26 @@ std::vector<LocalNodePtr> pangenome::Graph::get_node_closest_vcf_reference(
             continue;
         }
 
-        BOOST_LOG_TRIVIAL(debug) << "Increment coverages for path for sample "
-                                 << sample->name << " and prg " << node.prg_id;
+        BOOST_LOG_TRIVIAL(debug) << "Count votes for path for sample " << sample->name
+                                 << " and prg " << node.prg_id;
         const auto& sample_paths = sample->paths.at(node.prg_id);
         for (const auto& sample_path : sample_paths) {
-            for (uint32_t i = 0; i != sample_path.size(); ++i) {
-                const bool sample_path_node_is_valid
-                    = (sample_path[i]->id
-                          < kmer_prg_with_coverage.kmer_prg->nodes.size())
-                    and (kmer_prg_with_coverage.kmer_prg->nodes[sample_path[i]->id]
-                        != nullptr);
+            for (const auto node_id : sample_path.get_node_ids()) {
+                const bool sample_path_node_is_valid = (node_id < number_of_kmer_nodes)
+                    and (kmer_prg_with_coverage.kmer_prg->nodes[node_id] != nullptr);
                 if (!sample_path_node_is_valid) {
                     fatal_error("When getting the path closest to VCF reference, "
                                 "a sample path node is not valid");
                 }
 
-                kmer_prg_with_coverage.increment_forward_covg(sample_path[i]->id, 0);
-                kmer_prg_with_coverage.increment_reverse_covg(sample_path[i]->id, 0);
+                ++node_votes[node_id];
             }
         }
     }
 
-    kmer_prg_with_coverage.kmer_prg->discover_k();
-    kmer_prg_with_coverage.set_num_reads(node.covg);
-
     std::vector<KmerNodePtr> kmer_path;
-    kmer_prg_with_coverage.find_max_path(kmer_path, "lin", max_num_kmers_to_average, 0);
+    kmer_prg_with_coverage.find_max_path_from_votes(
+        kmer_path, node_votes, node.covg, max_num_kmers_to_average);
     if (!kmer_path.empty()) {
         auto reference_path = prg.localnode_path_from_kmernode_path(kmer_path, w);
         BOOST_LOG_TRIVIAL(debug) << "Found reference path to return";
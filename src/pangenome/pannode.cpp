@@ -1,5 +1,8 @@
 #include <iostream>
 #include <algorithm>
+#include <map>
+#include <tuple>
+#include <unordered_map>
 #include <boost/log/trivial.hpp>
 #include "pangenome/pannode.h"
 #include "pangenome/pansample.h"
@@ -155,35 +158,113 @@ void pangenome::Node::construct_multisample_vcf(VCF& master_vcf,
     BOOST_LOG_TRIVIAL(debug) << "Initial build:\n"
                              << vcf.to_string(true, false) << std::endl;
 
+    // each path of a sample is added as a sample of its own: the first path with the
+    // sample name, the next ones with the path number appended
+    std::vector<const SamplePath*> sample_kmer_paths;
+    std::vector<std::string> path_sample_names;
+    std::vector<uint32_t> path_sample_ids;
     for (const auto& sample : samples) {
+        const auto sample_paths_it = sample->paths.find(prg_id);
+        if (sample_paths_it == sample->paths.end()) {
+            continue;
+        }
         uint32_t count = 0;
-        for (const auto& sample_kmer_path : sample->paths[prg_id]) {
-            const auto sample_local_path
-                = prg->localnode_path_from_kmernode_path(sample_kmer_path, w);
-            if (count == 0) {
-                prg->add_new_records_and_genotype_to_vcf_using_max_likelihood_path_of_the_sample(
-                    vcf, vcf_reference_path, sample_local_path, sample->name);
-                BOOST_LOG_TRIVIAL(debug) << "With sample added:\n"
-                                         << vcf.to_string(true, false);
-                prg->add_sample_covgs_to_vcf(vcf, kmer_prg_with_coverage,
-                    vcf_reference_path, sample->name, sample->sample_id);
-                BOOST_LOG_TRIVIAL(debug) << "With sample coverages added:\n"
-                                         << vcf.to_string(true, false);
-            } else {
-                auto path_specific_sample_name = sample->name + std::to_string(count);
-                prg->add_new_records_and_genotype_to_vcf_using_max_likelihood_path_of_the_sample(
-                    vcf, vcf_reference_path, sample_local_path,
-                    path_specific_sample_name);
-                prg->add_sample_covgs_to_vcf(vcf, kmer_prg_with_coverage,
-                    vcf_reference_path, path_specific_sample_name, sample->sample_id);
-            }
+        for (const auto& sample_kmer_path : sample_paths_it->second) {
+            sample_kmer_paths.push_back(&sample_kmer_path);
+            path_sample_names.push_back(
+                count == 0 ? sample->name : sample->name + std::to_string(count));
+            path_sample_ids.push_back(sample->sample_id);
             count++;
         }
     }
-    vcf = vcf.merge_multi_allelic();
+    const size_t number_of_sample_paths = sample_kmer_paths.size();
+
+    // resolving the sample paths to k-mer nodes and converting them to local paths is
+    // independent for each path
+    std::vector<std::vector<LocalNodePtr>> sample_local_paths(number_of_sample_paths);
+    for (size_t path_index = 0; path_index < number_of_sample_paths; ++path_index) {
+#pragma omp task default(shared) firstprivate(path_index)
+        {
+            sample_local_paths[path_index] = prg->localnode_path_from_kmernode_path(
+                sample_kmer_paths[path_index]->get_kmer_path(
+                    *kmer_prg_with_coverage.kmer_prg),
+                w);
+        }
+    }
+#pragma omp taskwait
+
+    // the records added by a sample path depend on the records added by the previous
+    // ones, so this is done in order. The coverages of a path are only set on the
+    // records that exist once it is added, i.e. on the first records created, so we
+    // keep the order of creation of the records to compute the coverages afterwards
+    std::unordered_map<const VCFRecord*, size_t> record_to_creation_index;
+    std::vector<size_t> number_of_records_to_add_covgs_to(number_of_sample_paths);
+    std::vector<size_t> path_sample_indexes(number_of_sample_paths);
+    for (size_t path_index = 0; path_index < number_of_sample_paths; ++path_index) {
+        const auto& sample_name = path_sample_names[path_index];
+        prg->add_new_records_and_genotype_to_vcf_using_max_likelihood_path_of_the_sample(
+            vcf, vcf_reference_path, sample_local_paths[path_index], sample_name);
+        BOOST_LOG_TRIVIAL(debug) << "With sample " << sample_name << " added:\n"
+                                 << vcf.to_string(true, false);
+
+        // the records are sorted here as adding the coverages of a sample does
+        vcf.sort_records();
+        for (const auto& record : vcf.get_records()) {
+            const size_t creation_index = record_to_creation_index.size();
+            record_to_creation_index.emplace(record.get(), creation_index);
+        }
+        number_of_records_to_add_covgs_to[path_index] = record_to_creation_index.size();
+
+        const auto sample_it
+            = std::find(vcf.samples.begin(), vcf.samples.end(), sample_name);
+        const bool sample_is_valid = sample_it != vcf.samples.end();
+        if (!sample_is_valid) {
+            fatal_error(
+                "Error when adding sample coverages to VCF: sample is not valid");
+        }
+        path_sample_indexes[path_index] = std::distance(vcf.samples.begin(), sample_it);
+    }
+
+    // setting the coverages only touches the sample info of each sample, so it is
+    // independent for each sample. Paths sharing a sample index (only possible with
+    // clashing sample names) are processed together, in order, as they were before
+    std::map<size_t, std::vector<size_t>> sample_index_to_path_indexes;
+    for (size_t path_index = 0; path_index < number_of_sample_paths; ++path_index) {
+        sample_index_to_path_indexes[path_sample_indexes[path_index]].push_back(
+            path_index);
+    }
+    const std::vector<std::pair<size_t, std::vector<size_t>>> sample_index_groups(
+        sample_index_to_path_indexes.begin(), sample_index_to_path_indexes.end());
+    const auto ref_kmer_path = vcf.get_records().empty()
+        ? std::vector<KmerNodePtr>()
+        : prg->kmernode_path_from_localnode_path(vcf_reference_path);
+    for (size_t group_index = 0; group_index < sample_index_groups.size();
+         ++group_index) {
+#pragma omp task default(shared) firstprivate(group_index)
+        {
+            const auto& sample_index = sample_index_groups[group_index].first;
+            for (const auto path_index : sample_index_groups[group_index].second) {
+                std::vector<VCFRecord*> records_to_add_covgs_to;
+                for (const auto& record : vcf.get_records()) {
+                    if (record_to_creation_index.at(record.get())
+                        < number_of_records_to_add_covgs_to[path_index]) {
+                        records_to_add_covgs_to.push_back(record.get());
+                    }
+                }
+                prg->add_sample_covgs_to_vcf_records(records_to_add_covgs_to,
+                    kmer_prg_with_coverage, vcf_reference_path, ref_kmer_path,
+                    sample_index, path_sample_ids[path_index]);
+            }
+        }
+    }
+#pragma omp taskwait
+    BOOST_LOG_TRIVIAL(debug) << "With sample coverages added:\n"
+                             << vcf.to_string(true, false);
+
+    vcf.merge_multi_allelic_in_place();
     BOOST_LOG_TRIVIAL(debug) << "After merging alleles:\n"
                              << vcf.to_string(true, false);
-    vcf = vcf.correct_dot_alleles(
+    vcf.correct_dot_alleles_in_place(
         prg->string_along_path(vcf_reference_path), prg->name);
     BOOST_LOG_TRIVIAL(debug) << "After fixing dot alleles:\n"
                              << vcf.to_string(true, false);
@@ -202,40 +283,111 @@ std::ostream& pangenome::operator<<(std::ostream& out, pangenome::Node const& n)
     return out;
 }
 
+pangenome::Node::ReadHitTable pangenome::Node::build_read_hit_table() const
+{
+    ReadHitTable read_hit_table;
+    std::unordered_set<uint32_t> reads_already_added;
+
+    for (const auto& current_read : this->reads) {
+        const bool read_was_already_added
+            = !reads_already_added.insert(current_read->id).second;
+        if (read_was_already_added) {
+            continue;
+        }
+
+        for (uint32_t hit_index = 0; hit_index < current_read->hits.size();
+             ++hit_index) {
+            const MinimizerHit* const hit = current_read->hits[hit_index];
+            if (hit->get_prg_id() != this->prg_id) {
+                continue;
+            }
+            read_hit_table.push_back({ hit->get_prg_path().get_start(),
+                current_read->id, hit->get_read_start_position(), hit_index,
+                hit->is_forward(), &hit->get_prg_path() });
+        }
+    }
+
+    std::sort(read_hit_table.begin(), read_hit_table.end(),
+        [](const ReadHit& lhs, const ReadHit& rhs) {
+            return std::tie(lhs.prg_start, lhs.read_id, lhs.hit_index)
+                < std::tie(rhs.prg_start, rhs.read_id, rhs.hit_index);
+        });
+    return read_hit_table;
+}
+
 std::set<ReadCoordinate> pangenome::Node::get_read_overlap_coordinates(
     const prg::Path& local_path, const uint32_t& min_number_hits)
+{
+    return get_read_overlap_coordinates(
+        local_path, build_read_hit_table(), min_number_hits);
+}
+
+std::set<ReadCoordinate> pangenome::Node::get_read_overlap_coordinates(
+    const prg::Path& local_path, const ReadHitTable& read_hit_table,
+    const uint32_t& min_number_hits) const
 {
     std::set<ReadCoordinate> read_overlap_coordinates;
+    if (local_path.empty()) {
+        return read_overlap_coordinates;
+    }
 
-    for (const auto& current_read : this->reads) {
-        auto hits = current_read->get_hits_as_unordered_map();
-        const auto read_hits_inside_path { find_hits_inside_path(
-            hits.at(this->prg_id), local_path) };
+    struct ReadOverlap {
+        uint32_t number_of_hits;
+        uint32_t start;
+        uint32_t end;
+        uint32_t first_hit_index;
+        bool is_forward;
+    };
+    std::map<uint32_t, ReadOverlap> read_id_to_overlap;
 
-        if (read_hits_inside_path.size() < min_number_hits) {
+    // a hit can only be inside the local path if its PRG path starts inside it
+    auto read_hit_iter { std::lower_bound(read_hit_table.cbegin(),
+        read_hit_table.cend(), local_path.get_start(),
+        [](const ReadHit& read_hit, const uint32_t position) {
+            return read_hit.prg_start < position;
+        }) };
+    for (; read_hit_iter != read_hit_table.cend()
+         and read_hit_iter->prg_start <= local_path.get_end();
+         ++read_hit_iter) {
+        if (!read_hit_iter->prg_path->is_subpath(local_path)) {
             continue;
         }
 
-        const auto read_hits_iter { read_hits_inside_path.cbegin() };
-        uint32_t start { (*read_hits_iter)->get_read_start_position() };
-        uint32_t end { 0 };
+        const uint32_t hit_end
+            = read_hit_iter->read_position + read_hit_iter->prg_path->length();
+        const auto inserted { read_id_to_overlap.emplace(read_hit_iter->read_id,
+            ReadOverlap { 1, read_hit_iter->read_position, hit_end,
+                read_hit_iter->hit_index, read_hit_iter->is_forward }) };
+        if (inserted.second) {
+            continue;
+        }
 
-        for (const auto& read_hit : read_hits_inside_path) {
-            start = std::min(start, read_hit->get_read_start_position());
-            end = std::max(end,
-                read_hit->get_read_start_position()
-                    + read_hit->get_prg_path().length());
+        auto& overlap { inserted.first->second };
+        ++overlap.number_of_hits;
+        overlap.start = std::min(overlap.start, read_hit_iter->read_position);
+        overlap.end = std::max(overlap.end, hit_end);
+        // the strand of a read is given by its first hit inside the path
+        if (read_hit_iter->hit_index < overlap.first_hit_index) {
+            overlap.first_hit_index = read_hit_iter->hit_index;
+            overlap.is_forward = read_hit_iter->is_forward;
         }
+    }
 
-        const bool read_coordinates_are_valid = end > start;
+    for (const auto& read_id_and_overlap : read_id_to_overlap) {
+        const auto& overlap { read_id_and_overlap.second };
+        if (overlap.number_of_hits < min_number_hits) {
+            continue;
+        }
+
+        const bool read_coordinates_are_valid = overlap.end > overlap.start;
         if (!read_coordinates_are_valid) {
             fatal_error("Error finding the read overlap coordinates for node ", name,
-                " and read ", current_read->id, ". Found end ", end,
-                " after found start ", start);
+                " and read ", read_id_and_overlap.first, ". Found end ", overlap.end,
+                " after found start ", overlap.start);
         }
 
-        read_overlap_coordinates.emplace(
-            current_read->id, start, end, (*read_hits_iter)->is_forward());
+        read_overlap_coordinates.emplace(read_id_and_overlap.first, overlap.start,
+            overlap.end, overlap.is_forward);
     }
     return read_overlap_coordinates;
-}
\ No newline at end of file
+}
@@ -100,6 +100,54 @@ Read::get_hits_as_unordered_map() const
     return hitsMap;
 }
 
+const std::vector<uint32_t>& Read::get_positions_of_node_id(const uint32_t node_id)
+{
+    if (!node_id_to_positions_is_valid) {
+        node_id_to_positions.clear();
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            node_id_to_positions[nodes[i].lock()->node_id].push_back(i);
+        }
+        node_id_to_positions_is_valid = true;
+    }
+
+    static const std::vector<uint32_t> no_positions;
+    const auto positions_it = node_id_to_positions.find(node_id);
+    if (positions_it == node_id_to_positions.end()) {
+        return no_positions;
+    }
+    return positions_it->second;
+}
+
+std::vector<uint32_t> Read::get_candidate_positions(
+    const uint32_t first_node_id, const uint32_t number_of_node_ids)
+{
+    const auto& positions = get_positions_of_node_id(first_node_id);
+    const uint32_t number_of_nodes = nodes.size();
+    const uint32_t first_overhanging_position = number_of_nodes >= number_of_node_ids
+        ? number_of_nodes - number_of_node_ids + 1
+        : 0;
+
+    std::vector<uint32_t> candidates;
+    candidates.reserve(
+        2 * positions.size() + number_of_nodes - first_overhanging_position);
+    // matches going forwards start at the first node id
+    candidates.insert(candidates.end(), positions.begin(), positions.end());
+    // matches going backwards start at the first node id, counting from the end
+    for (auto position_it = positions.rbegin(); position_it != positions.rend();
+         ++position_it) {
+        candidates.push_back(number_of_nodes - 1 - *position_it);
+    }
+    // partial matches overlapping the start or the end of the read
+    for (uint32_t i = first_overhanging_position; i < number_of_nodes; ++i) {
+        candidates.push_back(i);
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(
+        std::unique(candidates.begin(), candidates.end()), candidates.end());
+    return candidates;
+}
+
 // find the index i in the nodes and node_orientations vectors such that [i,i+v.size()]
 // corresponds to these vectors of nodes or some vector overlapping end of read
 // NB will find the first such instance if there is more than one
@@ -119,7 +167,11 @@ std::pair<uint32_t, uint32_t> Read::find_position(
     uint32_t search_pos = 0;
     uint32_t found_pos = 0;
 
-    for (uint32_t i = 0; i < nodes.size(); ++i) {
+    // nothing can match at the other positions, so only these are searched, in the
+    // same order as a scan of the whole read
+    const auto candidate_positions
+        = get_candidate_positions(node_ids[0], node_ids.size());
+    for (const uint32_t i : candidate_positions) {
         // if first node matches at position i going forwards...
         if (nodes[i].lock()->node_id == node_ids[0]
             and node_orientations[i] == node_orients[0]) {
@@ -233,6 +285,7 @@ void Read::remove_all_nodes_with_this_id(const uint32_t node_id)
         uint32_t d = distance(nodes.begin(), it);
         nodes.erase(it);
         node_orientations.erase(node_orientations.begin() + d);
+        node_id_to_positions_is_valid = false;
         it = find_node_by_id(node_id);
     }
 }
@@ -243,12 +296,33 @@ std::vector<WeakNodePtr>::iterator Read::remove_node_with_iterator(
     uint32_t d = distance(nodes.begin(), nit);
     node_orientations.erase(node_orientations.begin() + d);
     nit = nodes.erase(nit);
+    node_id_to_positions_is_valid = false;
     return nit;
 }
 
 void Read::replace_node_with_iterator(
     std::vector<WeakNodePtr>::iterator n_original, NodePtr n)
 {
+    // the other nodes keep their positions, so just move this one to the new id
+    bool positions_were_updated = false;
+    const auto original_node = n_original->lock();
+    if (node_id_to_positions_is_valid and original_node) {
+        const uint32_t position = distance(nodes.begin(), n_original);
+        auto& original_positions = node_id_to_positions[original_node->node_id];
+        const auto original_position_it = std::lower_bound(
+            original_positions.begin(), original_positions.end(), position);
+        if (original_position_it != original_positions.end()
+            and *original_position_it == position) {
+            original_positions.erase(original_position_it);
+            auto& new_positions = node_id_to_positions[n->node_id];
+            new_positions.insert(
+                std::lower_bound(new_positions.begin(), new_positions.end(), position),
+                position);
+            positions_were_updated = true;
+        }
+    }
+    node_id_to_positions_is_valid = positions_were_updated;
+
     auto it = nodes.erase(n_original);
     nodes.insert(it, n);
 }
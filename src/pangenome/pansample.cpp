@@ -5,9 +5,78 @@
 #include <algorithm>
 #include "pangenome/pansample.h"
 #include "pangenome/pannode.h"
+#include "kmergraph.h"
+#include "kmernode.h"
+#include "fatal_error.h"
 
 using namespace pangenome;
 
+SamplePath::SamplePath(const std::vector<KmerNodePtr>& kmer_path)
+    : number_of_nodes(kmer_path.size())
+{
+    int64_t previous_id = 0;
+    for (const auto& kmer_node : kmer_path) {
+        const int64_t delta = (int64_t)kmer_node->id - previous_id;
+        uint64_t zigzag_delta = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+        while (zigzag_delta >= 0x80) {
+            encoded_node_ids.push_back((uint8_t)(zigzag_delta & 0x7F) | 0x80);
+            zigzag_delta >>= 7;
+        }
+        encoded_node_ids.push_back((uint8_t)zigzag_delta);
+        previous_id = kmer_node->id;
+    }
+    encoded_node_ids.shrink_to_fit();
+}
+
+std::vector<uint32_t> SamplePath::get_node_ids() const
+{
+    std::vector<uint32_t> node_ids;
+    node_ids.reserve(number_of_nodes);
+    int64_t previous_id = 0;
+    auto byte_it = encoded_node_ids.cbegin();
+    while (byte_it != encoded_node_ids.cend()) {
+        uint64_t zigzag_delta = 0;
+        uint32_t shift = 0;
+        while (*byte_it & 0x80) {
+            zigzag_delta |= (uint64_t)(*byte_it & 0x7F) << shift;
+            shift += 7;
+            ++byte_it;
+        }
+        zigzag_delta |= (uint64_t)*byte_it << shift;
+        ++byte_it;
+
+        const int64_t delta
+            = (int64_t)(zigzag_delta >> 1) ^ -(int64_t)(zigzag_delta & 1);
+        previous_id += delta;
+        node_ids.push_back((uint32_t)previous_id);
+    }
+    return node_ids;
+}
+
+std::vector<KmerNodePtr> SamplePath::get_kmer_path(const KmerGraph& kmer_graph) const
+{
+    std::vector<KmerNodePtr> kmer_path;
+    kmer_path.reserve(number_of_nodes);
+    for (const auto node_id : get_node_ids()) {
+        const bool node_is_valid = node_id < kmer_graph.nodes.size()
+            and kmer_graph.nodes[node_id] != nullptr;
+        if (!node_is_valid) {
+            fatal_error("Error resolving sample path: k-mer node ", node_id,
+                " is not in the k-mer graph");
+        }
+        kmer_path.push_back(kmer_graph.nodes[node_id]);
+    }
+    return kmer_path;
+}
+
+bool SamplePath::operator==(const SamplePath& other) const
+{
+    return number_of_nodes == other.number_of_nodes
+        and encoded_node_ids == other.encoded_node_ids;
+}
+
+bool SamplePath::operator!=(const SamplePath& other) const { return !(*this == other); }
+
 Sample::Sample(const std::string& s, const uint32_t& id)
     : name(s)
     , sample_id(id)
@@ -16,11 +85,7 @@ Sample::Sample(const std::string& s, const uint32_t& id)
 
 void Sample::add_path(const uint32_t node_id, const std::vector<KmerNodePtr>& c)
 {
-    if (paths.find(node_id) == paths.end()) {
-        paths[node_id] = { c };
-    } else {
-        paths[node_id].push_back(c);
-    }
+    paths[node_id].emplace_back(c);
 }
 
 bool Sample::operator==(const Sample& y) const
@@ -41,8 +106,8 @@ std::ostream& pangenome::operator<<(std::ostream& out, pangenome::Sample const&
     for (const auto& p : s.paths) {
         for (uint32_t i = 0; i != p.second.size(); ++i) {
             out << p.first << "\t";
-            for (const auto& n : p.second[i]) {
-                out << *n;
+            for (const auto& node_id : p.second[i].get_node_ids()) {
+                out << node_id << " ";
             }
             out << std::endl;
         }
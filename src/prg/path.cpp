@@ -329,4 +329,18 @@ prg::Path prg::get_union(const prg::Path& x, const prg::Path& y)
         }
     }
     return p;
-}
\ No newline at end of file
+}
+
+namespace std {
+size_t hash<prg::Path>::operator()(const prg::Path& path) const
+{
+    size_t seed = path.size();
+    for (const auto& interval : path) {
+        for (const uint32_t value : { interval.start, interval.length }) {
+            seed ^= std::hash<uint32_t>()(value) + 0x9e3779b9 + (seed << 6)
+                + (seed >> 2);
+        }
+    }
+    return seed;
+}
+}
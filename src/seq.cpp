@@ -5,50 +5,77 @@
 #include <boost/log/trivial.hpp>
 
 #include "inthash.h"
+#include "kmer_hashing.h"
 #include "minimizer.h"
 #include "seq.h"
+#include "syncmer.h"
 #include "utils.h"
 
 using std::vector;
 
-Seq::Seq(uint32_t i, const std::string& n, const std::string& p, uint32_t w, uint32_t k)
+Seq::Seq(uint32_t i, const std::string& n, const std::string& p, uint32_t w, uint32_t k,
+    uint32_t syncmer_size)
     : id(i)
     , name(n)
     , seq(p)
 {
-    minimizer_sketch(w, k);
+    if (syncmer_size > 0) {
+        syncmer_sketch(k, syncmer_size);
+    } else {
+        minimizer_sketch(w, k);
+    }
 }
 
 Seq::~Seq() { sketch.clear(); }
 
-void Seq::initialize(
-    uint32_t i, const std::string& n, const std::string& p, uint32_t w, uint32_t k)
+void Seq::initialize(uint32_t i, boost::string_ref n, boost::string_ref p, uint32_t w,
+    uint32_t k, uint32_t syncmer_size)
 {
     id = i;
-    name = n;
-    seq = p;
+    name.assign(n.data(), n.size());
+    seq.assign(p.data(), p.size());
     sketch.clear();
-    minimizer_sketch(w, k);
+    if (syncmer_size > 0) {
+        syncmer_sketch(k, syncmer_size);
+    } else {
+        minimizer_sketch(w, k);
+    }
 }
 
-bool Seq::add_letter_to_get_next_kmer(const char& letter, const uint64_t& shift1,
-    const uint64_t& mask, uint32_t& buff, uint64_t (&kmer)[2], uint64_t (&kh)[2])
+// fills hashes with the forward and reverse complement 2-bit encodings of the k-mers
+// of seq, and hashes them all in one batch. Returns false (with an empty sketch) if seq
+// has a non-ACGT base
+bool Seq::hash_kmers_of_sequence(const uint32_t k, std::vector<uint64_t>& hashes)
 {
-    uint32_t c = nt4((uint8_t)letter);
-    if (c < 4) { // not an ambiguous base
+    const uint64_t shift1 = 2 * (k - 1), mask = (1ULL << 2 * k) - 1;
+    const size_t number_of_kmers = seq.length() + 1 - k;
+    hashes.resize(2 * number_of_kmers);
+    uint64_t* forward_kmers = hashes.data();
+    uint64_t* reverse_kmers = forward_kmers + number_of_kmers;
+
+    uint64_t kmer[2] = { 0, 0 };
+    uint32_t buff = 0;
+    for (const char letter : seq) {
+        uint32_t c = nt4((uint8_t)letter);
+        if (c >= 4) { // an ambiguous base
+            BOOST_LOG_TRIVIAL(debug)
+                << now()
+                << "bad letter - found a non AGCT base in read so skipping read "
+                << name;
+            sketch.clear();
+            return false;
+        }
         kmer[0] = (kmer[0] << 2 | c) & mask; // forward k-mer
         kmer[1] = (kmer[1] >> 2) | (3ULL ^ c) << shift1; // reverse k-mer
-        kh[0] = hash64(kmer[0], mask);
-        kh[1] = hash64(kmer[1], mask);
         buff++;
-        return true;
-    } else {
-        BOOST_LOG_TRIVIAL(debug)
-            << now() << "bad letter - found a non AGCT base in read so skipping read "
-            << name;
-        sketch.clear();
-        return false;
+        if (buff >= k) {
+            forward_kmers[buff - k] = kmer[0];
+            reverse_kmers[buff - k] = kmer[1];
+        }
     }
+
+    hash_kmers(hashes.data(), hashes.data(), hashes.size(), mask);
+    return true;
 }
 
 uint64_t find_smallest_kmer_value(
@@ -101,24 +128,22 @@ void Seq::minimizer_sketch(const uint32_t w, const uint32_t k)
     if (sequence_too_short_to_sketch)
         return;
 
-    // initializations
-    uint64_t shift1 = 2 * (k - 1), mask = (1ULL << 2 * k) - 1,
-             smallest = std::numeric_limits<uint64_t>::max(), kmer[2] = { 0, 0 },
-             kh[2] = { 0, 0 };
-    uint32_t buff = 0;
+    if (not hash_kmers_of_sequence(k, kmer_hashes))
+        return;
+    const uint32_t number_of_kmers = kmer_hashes.size() / 2;
+    const uint64_t* forward_hashes = kmer_hashes.data();
+    const uint64_t* reverse_hashes = forward_hashes + number_of_kmers;
+
+    uint64_t smallest = std::numeric_limits<uint64_t>::max();
     vector<Minimizer> window; // will store all k-mers as Minimizer in the window
     window.reserve(w);
 
-    for (const char letter : seq) {
-        const bool added = add_letter_to_get_next_kmer(letter, shift1, mask, buff, kmer,
-            kh); // add the next base and remove the first one to get the next kmer
-        if (not added)
-            return;
-
-        if (buff >= k) {
-            window.push_back(
-                Minimizer(std::min(kh[0], kh[1]), buff - k, buff, (kh[0] <= kh[1])));
-        }
+    for (uint32_t i = 0; i < number_of_kmers; ++i) {
+        const uint32_t buff = i + k; // number of letters read so far
+        const uint64_t forward_hash = forward_hashes[i];
+        const uint64_t reverse_hash = reverse_hashes[i];
+        window.push_back(Minimizer(std::min(forward_hash, reverse_hash), i, buff,
+            (forward_hash <= reverse_hash)));
 
         if (window.size() == w) {
             minimize_window(window,
@@ -140,6 +165,41 @@ void Seq::minimizer_sketch(const uint32_t w, const uint32_t k)
     }
 }
 
+// adds the open syncmers of seq to the sketch. They are chosen k-mer by k-mer, so there
+// is no window to maintain
+void Seq::syncmer_sketch(const uint32_t k, const uint32_t s)
+{
+    const bool sequence_too_short_to_sketch = seq.length() < k;
+    if (sequence_too_short_to_sketch)
+        return;
+
+    if (not hash_kmers_of_sequence(k, kmer_hashes)
+        or not hash_kmers_of_sequence(s, smer_hashes))
+        return;
+    const uint32_t number_of_kmers = kmer_hashes.size() / 2;
+    const uint32_t number_of_smers = smer_hashes.size() / 2;
+    const uint32_t number_of_smers_in_a_kmer = k - s + 1;
+    const uint64_t* forward_kmer_hashes = kmer_hashes.data();
+    const uint64_t* reverse_kmer_hashes = forward_kmer_hashes + number_of_kmers;
+    const uint64_t* forward_smer_hashes = smer_hashes.data();
+    const uint64_t* reverse_smer_hashes = forward_smer_hashes + number_of_smers;
+
+    for (uint32_t i = 0; i < number_of_kmers; ++i) {
+        const uint64_t forward_hash = forward_kmer_hashes[i];
+        const uint64_t reverse_hash = reverse_kmer_hashes[i];
+        const bool forward_is_canonical = forward_hash <= reverse_hash;
+        const uint64_t* smer_hashes_of_kmer = (forward_is_canonical
+                ? forward_smer_hashes
+                : reverse_smer_hashes)
+            + i;
+        if (is_open_syncmer(
+                smer_hashes_of_kmer, number_of_smers_in_a_kmer, forward_is_canonical)) {
+            sketch.insert(Minimizer(std::min(forward_hash, reverse_hash), i, i + k,
+                forward_is_canonical));
+        }
+    }
+}
+
 std::ostream& operator<<(std::ostream& out, Seq const& data)
 {
     out << data.name;
@@ -0,0 +1,28 @@
+#include "syncmer.h"
+
+bool is_open_syncmer(const uint64_t* smer_hashes, const uint32_t number_of_smers,
+    const bool forward_is_canonical)
+{
+    // the first s-mer of the reverse complement k-mer is the last one of the forward
+    // k-mer. Ties are broken by taking the first smallest s-mer along the canonical
+    // strand, so the first s-mer only needs to be no larger than the others
+    const uint32_t first_smer = forward_is_canonical ? 0 : number_of_smers - 1;
+    for (uint32_t i = 0; i < number_of_smers; ++i) {
+        if (smer_hashes[i] < smer_hashes[first_smer]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool is_open_syncmer(const std::string& kmer, const uint32_t s,
+    const bool forward_is_canonical, KmerHash& hash)
+{
+    const uint32_t number_of_smers = kmer.length() + 1 - s;
+    std::vector<uint64_t> smer_hashes(number_of_smers);
+    for (uint32_t i = 0; i < number_of_smers; ++i) {
+        const auto smer_hash = hash.kmerhash(kmer.substr(i, s), s);
+        smer_hashes[i] = forward_is_canonical ? smer_hash.first : smer_hash.second;
+    }
+    return is_open_syncmer(smer_hashes.data(), number_of_smers, forward_is_canonical);
+}
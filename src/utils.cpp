@@ -17,6 +17,7 @@
 #include "noise_filtering.h"
 #include "minihit.h"
 #include "fastaq_handler.h"
+#include "inthash.h"
 
 std::string now()
 {
@@ -107,11 +108,14 @@ float lognchoosek2(uint32_t n, uint32_t k1, uint32_t k2)
     return total;
 }
 
-void read_prg_file(
-    std::vector<std::shared_ptr<LocalPRG>>& prgs, const fs::path& filepath, uint32_t id)
+void read_prg_file(std::vector<std::shared_ptr<LocalPRG>>& prgs,
+    const fs::path& filepath, uint32_t id,
+    const std::unordered_set<std::string>& loci_to_load, const bool release_seqs)
 {
     BOOST_LOG_TRIVIAL(debug) << "Loading PRGs from file " << filepath;
 
+    const bool load_all_loci = loci_to_load.empty();
+    uint32_t number_of_prgs_loaded = 0;
     FastaqHandler fh(filepath.string());
     while (!fh.eof()) {
         try {
@@ -121,17 +125,241 @@ void read_prg_file(
         }
         if (fh.name.empty() or fh.read.empty())
             continue;
+        // PRGs not in loci_to_load keep their id, but are not built
+        if (!load_all_loci and loci_to_load.find(fh.name) == loci_to_load.end()) {
+            prgs.push_back(nullptr);
+            id++;
+            continue;
+        }
         auto s = std::make_shared<LocalPRG>(LocalPRG(id, fh.name,
             fh.read)); // build a node in the graph, which will represent a LocalPRG
                        // (the graph is a list of nodes, each representing a LocalPRG)
         if (s != nullptr) {
+            if (release_seqs) {
+                s->release_seq();
+            }
             prgs.push_back(s);
             id++;
+            number_of_prgs_loaded++;
         } else {
             fatal_error("Failed to make LocalPRG for ", fh.name);
         }
     }
+    BOOST_LOG_TRIVIAL(debug) << "Number of LocalPRGs read: " << number_of_prgs_loaded;
+
+    if (!load_all_loci and number_of_prgs_loaded != loci_to_load.size()) {
+        BOOST_LOG_TRIVIAL(warning)
+            << "Only " << number_of_prgs_loaded << " of the " << loci_to_load.size()
+            << " loci given were found in " << filepath;
+    }
+}
+
+namespace {
+// parses a non-negative integer that fits in 32 bits
+bool parse_uint32(const std::string& s, uint32_t& value)
+{
+    if (s.empty() or s.size() > 10
+        or s.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    const uint64_t parsed_value = std::stoull(s);
+    if (parsed_value > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+    value = parsed_value;
+    return true;
+}
+
+// the number of PRGs read_prg_file would load from a file, without building them
+uint32_t count_prgs(const fs::path& filepath)
+{
+    uint32_t number_of_prgs = 0;
+    FastaqHandler fh(filepath.string());
+    while (!fh.eof()) {
+        try {
+            fh.get_next_view();
+        } catch (std::out_of_range& err) {
+            break;
+        }
+        if (!fh.name_view.empty() and !fh.read_view.empty()) {
+            ++number_of_prgs;
+        }
+    }
+    return number_of_prgs;
+}
+}
+
+PrgSlice PrgSlice::from_string(const std::string& slice)
+{
+    PrgSlice prg_slice;
+    const auto separator_position = slice.find_first_of("-/");
+    uint32_t first = 0;
+    uint32_t second = 0;
+    const bool is_well_formed = separator_position != std::string::npos
+        and parse_uint32(slice.substr(0, separator_position), first)
+        and parse_uint32(slice.substr(separator_position + 1), second);
+    if (!is_well_formed) {
+        fatal_error("Slice of PRGs ", slice, " should be given as START-END or I/N");
+    }
+
+    if (slice[separator_position] == '-') {
+        if (first >= second) {
+            fatal_error(
+                "Slice of PRGs ", slice, " is empty: START must be less than END");
+        }
+        prg_slice.start = first;
+        prg_slice.end = second;
+    } else {
+        if (first == 0 or first > second) {
+            fatal_error("Slice of PRGs ", slice, " should have 1 <= I <= N");
+        }
+        prg_slice.shard_number = first;
+        prg_slice.number_of_shards = second;
+    }
+    return prg_slice;
+}
+
+std::pair<uint32_t, uint32_t> PrgSlice::get_range(const uint32_t number_of_prgs) const
+{
+    if (is_shard()) {
+        const uint64_t first
+            = (uint64_t)(shard_number - 1) * number_of_prgs / number_of_shards;
+        const uint64_t second
+            = (uint64_t)shard_number * number_of_prgs / number_of_shards;
+        return { first, second };
+    }
+    return { std::min(start, number_of_prgs), std::min(end, number_of_prgs) };
+}
+
+std::vector<uint64_t> get_prg_record_offsets(
+    const fs::path& prgfile, const bool use_saved_offsets)
+{
+    std::vector<uint64_t> offsets;
+    const fs::path offsets_filepath { prgfile.string() + ".offsets" };
+    const uint64_t prgfile_size = fs::file_size(prgfile);
+    const bool offsets_file_may_be_up_to_date = use_saved_offsets
+        and fs::exists(offsets_filepath)
+        and fs::last_write_time(offsets_filepath) >= fs::last_write_time(prgfile);
+    if (offsets_file_may_be_up_to_date) {
+        // the offsets file starts with the size of the PRG file it was made from, as
+        // the PRG file may have been replaced by an older or same-second copy
+        fs::ifstream instream(offsets_filepath);
+        std::string size_tag;
+        uint64_t saved_prgfile_size;
+        const bool prgfile_size_matches
+            = instream >> size_tag >> saved_prgfile_size and size_tag == "#size"
+            and saved_prgfile_size == prgfile_size;
+        if (prgfile_size_matches) {
+            BOOST_LOG_TRIVIAL(debug)
+                << "Loading PRG record offsets from " << offsets_filepath;
+            uint64_t offset;
+            while (instream >> offset) {
+                offsets.push_back(offset);
+            }
+            return offsets;
+        }
+    }
+
+    BOOST_LOG_TRIVIAL(debug) << "Skimming the PRG records of " << prgfile;
+    FastaqHandler fh(prgfile.string());
+    if (!fh.is_memory_mapped()) {
+        fatal_error("Cannot get the record offsets of ", prgfile,
+            ": only uncompressed PRG files can be seeked into");
+    }
+    while (!fh.eof()) {
+        const uint64_t offset = fh.get_mapped_position();
+        try {
+            fh.get_next_view();
+        } catch (std::out_of_range& err) {
+            break;
+        }
+        if (!fh.name_view.empty() and !fh.read_view.empty()) {
+            offsets.push_back(offset);
+        }
+    }
+
+    // several slices can be indexed at the same time, so the offsets are written to a
+    // temporary file that is then renamed, for readers to never see a partial file
+    fs::path temporary_filepath { offsets_filepath };
+    temporary_filepath += fs::unique_path(".%%%%-%%%%-%%%%.tmp");
+    {
+        fs::ofstream outstream(temporary_filepath);
+        outstream << "#size " << prgfile_size << "\n";
+        for (const auto& offset : offsets) {
+            outstream << offset << "\n";
+        }
+    }
+    boost::system::error_code error;
+    fs::rename(temporary_filepath, offsets_filepath, error);
+    if (error) {
+        BOOST_LOG_TRIVIAL(warning) << "Could not save the PRG record offsets to "
+                                   << offsets_filepath << ": " << error.message();
+        fs::remove(temporary_filepath, error);
+    }
+    return offsets;
+}
+
+uint32_t read_prg_file_slice(std::vector<std::shared_ptr<LocalPRG>>& prgs,
+    const fs::path& filepath, const PrgSlice& slice, uint32_t id)
+{
+    FastaqHandler fh(filepath.string());
+    std::pair<uint32_t, uint32_t> range;
+    uint32_t prg_position = 0; // position in the file of the next PRG read
+    if (fh.is_memory_mapped()) {
+        auto record_offsets = get_prg_record_offsets(filepath);
+        range = slice.get_range(record_offsets.size());
+        // the saved offsets are checked to start records where the slice is cut, in
+        // case they were saved for another version of the PRG file. Reading from
+        // offset 0 always finds the first record, even after leading blank lines
+        const auto offset_starts_record = [&](const uint32_t record_index) {
+            return record_index == record_offsets.size()
+                or record_offsets[record_index] == 0
+                or fh.mapped_position_starts_record(record_offsets[record_index]);
+        };
+        const bool record_offsets_are_stale = range.first != range.second
+            and !(offset_starts_record(range.first)
+                and offset_starts_record(range.second));
+        if (record_offsets_are_stale) {
+            BOOST_LOG_TRIVIAL(warning) << "The PRG record offsets saved for " << filepath
+                                       << " do not match it, skimming it again";
+            record_offsets = get_prg_record_offsets(filepath, false);
+            range = slice.get_range(record_offsets.size());
+        }
+        if (range.first == range.second) {
+            BOOST_LOG_TRIVIAL(warning)
+                << "The slice of PRGs to load has no PRG among the "
+                << record_offsets.size() << " PRGs of " << filepath;
+            return range.first;
+        }
+        fh.seek_mapped_position(record_offsets[range.first]);
+        prg_position = range.first;
+    } else {
+        // the number of PRGs is only needed to split the file into shards
+        const uint32_t number_of_prgs = slice.is_shard()
+            ? count_prgs(filepath)
+            : std::numeric_limits<uint32_t>::max();
+        range = slice.get_range(number_of_prgs);
+    }
+    BOOST_LOG_TRIVIAL(debug) << "Loading PRGs " << range.first << " to "
+                             << range.second << " (excluded) from file " << filepath;
+
+    while (!fh.eof() and prg_position < range.second) {
+        try {
+            fh.get_next_view();
+        } catch (std::out_of_range& err) {
+            break;
+        }
+        if (fh.name_view.empty() or fh.read_view.empty()) {
+            continue;
+        }
+        if (prg_position >= range.first) {
+            prgs.push_back(std::make_shared<LocalPRG>(id + prg_position,
+                fh.name_view.to_string(), fh.read_view.to_string()));
+        }
+        ++prg_position;
+    }
     BOOST_LOG_TRIVIAL(debug) << "Number of LocalPRGs read: " << prgs.size();
+    return range.first;
 }
 
 void load_PRG_kmergraphs(std::vector<std::shared_ptr<LocalPRG>>& prgs,
@@ -142,19 +370,66 @@ void load_PRG_kmergraphs(std::vector<std::shared_ptr<LocalPRG>>& prgs,
 
     auto dir_num = 0;
     fs::path dir;
-    for (const auto& prg : prgs) {
-        if (prg->id % 4000 == 0) {
+    for (uint32_t prg_index = 0; prg_index != prgs.size(); ++prg_index) {
+        if (prg_index % 4000 == 0) {
             dir = kmer_prgs_dir / int_to_string(dir_num + 1);
             dir_num++;
             if (not fs::exists(dir))
                 dir = kmer_prgs_dir;
         }
+        const auto& prg = prgs[prg_index];
+        if (prg == nullptr) {
+            continue;
+        }
         const auto filename { prg->name + ".k" + std::to_string(k) + ".w"
             + std::to_string(w) + ".gfa" };
         prg->kmer_prg.load(dir / filename);
+
+        // VCF sites are only saved by index --save-vcf-sites, and read when needed
+        const auto vcf_sites_file { dir / (prg->name + ".vcf_sites") };
+        if (fs::exists(vcf_sites_file)) {
+            prg->vcf_sites_file = vcf_sites_file;
+        }
     }
 }
 
+std::unordered_set<std::string> load_loci_file(const fs::path& loci_filepath)
+{
+    std::unordered_set<std::string> loci;
+    std::string line;
+    fs::ifstream instream(loci_filepath);
+    if (instream.is_open()) {
+        while (getline(instream, line)) {
+            std::istringstream linestream(line);
+            std::string locus;
+            if (linestream >> locus) {
+                loci.insert(locus);
+            }
+        }
+    } else {
+        fatal_error("Unable to open loci file ", loci_filepath);
+    }
+
+    if (loci.empty()) {
+        fatal_error("No loci given in loci file ", loci_filepath);
+    }
+    BOOST_LOG_TRIVIAL(info) << "Finished loading " << loci.size()
+                            << " loci from loci file";
+    return loci;
+}
+
+std::unordered_set<uint32_t> get_loaded_prg_ids(
+    const std::vector<std::shared_ptr<LocalPRG>>& prgs)
+{
+    std::unordered_set<uint32_t> loaded_prg_ids;
+    for (const auto& prg : prgs) {
+        if (prg != nullptr) {
+            loaded_prg_ids.insert(prg->id);
+        }
+    }
+    return loaded_prg_ids;
+}
+
 void load_vcf_refs_file(const fs::path& filepath, VCFRefs& vcf_refs)
 {
     BOOST_LOG_TRIVIAL(info) << "Loading VCF refs from file " << filepath;
@@ -190,11 +465,88 @@ void add_read_hits(const Seq& sequence,
     }
 }
 
+uint32_t get_cluster_size_threshold(const std::shared_ptr<LocalPRG>& prg,
+    const uint32_t min_cluster_size,
+    const uint32_t expected_number_kmers_in_read_sketch,
+    const float& fraction_kmers_required_for_cluster,
+    const float query_sketch_density_ratio)
+{
+    // keep clusters which cover at least 1/2 the expected number of minihits
+    // (a sparser read sketch only hits a fraction of the PRG minimizers)
+    const uint32_t prg_min_path_length
+        = prg->kmer_prg.min_path_length() * query_sketch_density_ratio;
+    const uint32_t length_based_threshold
+        = std::min(prg_min_path_length, expected_number_kmers_in_read_sketch)
+        * fraction_kmers_required_for_cluster;
+    return std::max(length_based_threshold, min_cluster_size);
+}
+
+uint64_t add_read_hits(const Seq& sequence,
+    const std::shared_ptr<MinimizerHits>& minimizer_hits, const Index& index,
+    const std::vector<std::shared_ptr<LocalPRG>>& prgs, const uint32_t min_cluster_size,
+    const uint32_t expected_number_kmers_in_read_sketch,
+    const float& fraction_kmers_required_for_cluster,
+    const float query_sketch_density_ratio)
+{
+    // a cluster only has hits of a single (PRG, strand) pair of the read, so we first
+    // count the hits of each pair, and only add the hits of the pairs having more hits
+    // than the cluster size threshold of their PRG
+    const auto get_pair_key = [](const Minimizer& minimizer, const MiniRecord& record) {
+        const bool is_forward = minimizer.is_forward_strand == record.strand;
+        return ((uint64_t)record.prg_id << 1) | (uint64_t)is_forward;
+    };
+
+    std::vector<std::pair<const Minimizer*, const std::vector<MiniRecord>*>>
+        sketch_records;
+    sketch_records.reserve(sequence.sketch.size());
+    std::unordered_map<uint64_t, uint32_t> pair_key_to_number_of_hits;
+    uint64_t number_of_hits { 0 };
+    for (const Minimizer& minimizer : sequence.sketch) {
+        const auto minhash_it = index.minhash.find(minimizer.canonical_kmer_hash);
+        if (minhash_it == index.minhash.end()) {
+            continue;
+        }
+        sketch_records.emplace_back(&minimizer, minhash_it->second);
+        for (const MiniRecord& record : *(minhash_it->second)) {
+            ++pair_key_to_number_of_hits[get_pair_key(minimizer, record)];
+        }
+        number_of_hits += minhash_it->second->size();
+    }
+
+    // pairs that can never form a cluster are marked by a count of 0
+    for (auto& pair_key_and_number_of_hits : pair_key_to_number_of_hits) {
+        const uint32_t prg_id = pair_key_and_number_of_hits.first >> 1;
+        const uint32_t cluster_size_threshold
+            = get_cluster_size_threshold(prgs[prg_id], min_cluster_size,
+                expected_number_kmers_in_read_sketch,
+                fraction_kmers_required_for_cluster, query_sketch_density_ratio);
+        if (pair_key_and_number_of_hits.second <= cluster_size_threshold) {
+            pair_key_and_number_of_hits.second = 0;
+        }
+    }
+
+    for (const auto& minimizer_and_records : sketch_records) {
+        const Minimizer& minimizer = *minimizer_and_records.first;
+        for (const MiniRecord& record : *minimizer_and_records.second) {
+            if (pair_key_to_number_of_hits[get_pair_key(minimizer, record)] > 0) {
+                minimizer_hits->add_hit(sequence.id, minimizer, record);
+            }
+        }
+    }
+
+    BOOST_LOG_TRIVIAL(trace) << "Read " << sequence.id << " has " << number_of_hits
+                             << " hits, " << minimizer_hits->hits.size()
+                             << " kept after discarding (locus, strand) pairs with "
+                                "too few hits to form a cluster";
+    return number_of_hits;
+}
+
 void define_clusters(std::set<MinimizerHitCluster, clusterComp>& clusters_of_hits,
     const std::vector<std::shared_ptr<LocalPRG>>& prgs,
     std::shared_ptr<MinimizerHits> minimizer_hits, const int max_diff,
     const float& fraction_kmers_required_for_cluster, const uint32_t min_cluster_size,
-    const uint32_t expected_number_kmers_in_read_sketch)
+    const uint32_t expected_number_kmers_in_read_sketch,
+    const float query_sketch_density_ratio)
 {
     BOOST_LOG_TRIVIAL(trace) << "Define clusters of hits from the "
                              << minimizer_hits->hits.size() << " hits";
@@ -208,7 +560,7 @@ void define_clusters(std::set<MinimizerHitCluster, clusterComp>& clusters_of_hit
     auto mh_previous = minimizer_hits->hits.begin();
     MinimizerHitCluster current_cluster;
     current_cluster.insert(*mh_previous);
-    uint32_t length_based_threshold;
+    uint32_t cluster_size_threshold;
     for (auto mh_current = ++minimizer_hits->hits.begin();
          mh_current != minimizer_hits->hits.end(); ++mh_current) {
         if ((*mh_current)->get_read_id() != (*mh_previous)->get_read_id()
@@ -217,48 +569,32 @@ void define_clusters(std::set<MinimizerHitCluster, clusterComp>& clusters_of_hit
             or (abs((int)(*mh_current)->get_read_start_position()
                    - (int)(*mh_previous)->get_read_start_position()))
                 > max_diff) {
-            // keep clusters which cover at least 1/2 the expected number of minihits
-            length_based_threshold
-                = std::min(
-                      prgs[(*mh_previous)->get_prg_id()]->kmer_prg.min_path_length(),
-                      expected_number_kmers_in_read_sketch)
-                * fraction_kmers_required_for_cluster;
-            BOOST_LOG_TRIVIAL(trace)
-                << "Length based cluster threshold min("
-                << prgs[(*mh_previous)->get_prg_id()]->kmer_prg.min_path_length()
-                << ", " << expected_number_kmers_in_read_sketch << ") * "
-                << fraction_kmers_required_for_cluster << " = "
-                << length_based_threshold;
-
-            if (current_cluster.size()
-                > std::max(length_based_threshold, min_cluster_size)) {
+            cluster_size_threshold
+                = get_cluster_size_threshold(prgs[(*mh_previous)->get_prg_id()],
+                    min_cluster_size, expected_number_kmers_in_read_sketch,
+                    fraction_kmers_required_for_cluster, query_sketch_density_ratio);
+            if (current_cluster.size() > cluster_size_threshold) {
                 clusters_of_hits.insert(current_cluster);
             } else {
                 BOOST_LOG_TRIVIAL(trace)
                     << "Rejected cluster of size " << current_cluster.size()
-                    << " < max(" << length_based_threshold << ", " << min_cluster_size
-                    << ")";
+                    << " <= " << cluster_size_threshold;
             }
             current_cluster.clear();
         }
         current_cluster.insert(*mh_current);
         mh_previous = mh_current;
     }
-    length_based_threshold
-        = std::min(prgs[(*mh_previous)->get_prg_id()]->kmer_prg.min_path_length(),
-              expected_number_kmers_in_read_sketch)
-        * fraction_kmers_required_for_cluster;
-    BOOST_LOG_TRIVIAL(trace)
-        << "Length based cluster threshold min("
-        << prgs[(*mh_previous)->get_prg_id()]->kmer_prg.min_path_length() << ", "
-        << expected_number_kmers_in_read_sketch << ") * "
-        << fraction_kmers_required_for_cluster << " = " << length_based_threshold;
-    if (current_cluster.size() > std::max(length_based_threshold, min_cluster_size)) {
+    cluster_size_threshold = get_cluster_size_threshold(
+        prgs[(*mh_previous)->get_prg_id()], min_cluster_size,
+        expected_number_kmers_in_read_sketch, fraction_kmers_required_for_cluster,
+        query_sketch_density_ratio);
+    if (current_cluster.size() > cluster_size_threshold) {
         clusters_of_hits.insert(current_cluster);
     } else {
-        BOOST_LOG_TRIVIAL(trace)
-            << "Rejected cluster of size " << current_cluster.size() << " < max("
-            << length_based_threshold << ", " << min_cluster_size << ")";
+        BOOST_LOG_TRIVIAL(trace) << "Rejected cluster of size "
+                                 << current_cluster.size() << " <= "
+                                 << cluster_size_threshold;
     }
 
     BOOST_LOG_TRIVIAL(trace) << "Found " << clusters_of_hits.size()
@@ -377,7 +713,8 @@ void infer_localPRG_order_for_reads(const std::vector<std::shared_ptr<LocalPRG>>
     std::shared_ptr<pangenome::Graph> pangraph, const int max_diff,
     const uint32_t& genome_size, const float& fraction_kmers_required_for_cluster,
     const uint32_t min_cluster_size,
-    const uint32_t expected_number_kmers_in_read_sketch)
+    const uint32_t expected_number_kmers_in_read_sketch,
+    const float query_sketch_density_ratio)
 {
     // this step infers the gene order for a read and adds this to the pangraph
     // by defining clusters of hits, keeping those which are not noise and
@@ -389,7 +726,7 @@ void infer_localPRG_order_for_reads(const std::vector<std::shared_ptr<LocalPRG>>
     std::set<MinimizerHitCluster, clusterComp> clusters_of_hits;
     define_clusters(clusters_of_hits, prgs, minimizer_hits, max_diff,
         fraction_kmers_required_for_cluster, min_cluster_size,
-        expected_number_kmers_in_read_sketch);
+        expected_number_kmers_in_read_sketch, query_sketch_density_ratio);
 
     filter_clusters(clusters_of_hits);
     // filter_clusters2(clusters_of_hits, genome_size);
@@ -400,31 +737,95 @@ void infer_localPRG_order_for_reads(const std::vector<std::shared_ptr<LocalPRG>>
     }
 }
 
+float get_query_sketch_density_ratio(const uint32_t w, const uint32_t query_w)
+{
+    const bool query_window_is_valid = query_w >= w;
+    if (!query_window_is_valid) {
+        fatal_error("The window size used to sketch reads (", query_w,
+            ") must not be smaller than the index window size (", w, ")");
+    }
+    // a (w,k)-minimizer sketch has an expected density of 2/(w+1)
+    return (float)(w + 1) / (float)(query_w + 1);
+}
+
+uint32_t get_expected_number_kmers_in_read_sketch(const uint32_t read_length,
+    const uint32_t query_w, const uint32_t k, const uint32_t syncmer_size)
+{
+    // open syncmers have an expected density of 1/(k-s+1), whatever the window size
+    if (syncmer_size > 0) {
+        return read_length / (k - syncmer_size + 1);
+    }
+    return read_length * 2 / (query_w + 1);
+}
+
 // TODO: this should be in a constructor of pangenome::Graph or in a factory class
 uint32_t pangraph_from_read_file(const std::string& filepath,
     std::shared_ptr<pangenome::Graph> pangraph, std::shared_ptr<Index> index,
     const std::vector<std::shared_ptr<LocalPRG>>& prgs, const uint32_t w,
     const uint32_t k, const int max_diff, const float& e_rate,
     const uint32_t min_cluster_size, const uint32_t genome_size, const bool illumina,
-    const bool clean, const uint32_t max_covg, uint32_t threads)
+    const bool clean, const uint32_t max_covg, uint32_t threads, uint32_t query_w,
+    const float subsample_fraction, const uint32_t target_covg,
+    const bool clean_by_component)
 {
+    // reads are sketched with syncmers if the PRGs of the index were
+    const uint32_t syncmer_size = index->syncmer_size;
+    if (syncmer_size > 0) {
+        const bool query_window_is_valid = query_w == 0 or query_w == w;
+        if (!query_window_is_valid) {
+            fatal_error("A window size to sketch reads cannot be given with an index "
+                        "sketched with syncmers");
+        }
+        BOOST_LOG_TRIVIAL(info) << "Sketching reads with open syncmers of s-mer size "
+                                << syncmer_size << ", as the index";
+    }
+    // reads are sketched with the index window unless a sparser sketch is requested.
+    // Every (query_w,k)-minimizer is also a (w,k)-minimizer of a contained window, so
+    // the read sketch is a subset of the index-compatible one
+    if (query_w == 0) {
+        query_w = w;
+    }
+    const float query_sketch_density_ratio = get_query_sketch_density_ratio(w, query_w);
+    const uint32_t query_min_cluster_size = std::max(
+        1u, (uint32_t)std::round(min_cluster_size * query_sketch_density_ratio));
+    if (query_w != w) {
+        BOOST_LOG_TRIVIAL(info) << "Sketching reads with window size " << query_w
+                                << " (index window size " << w
+                                << "), min cluster size scaled to "
+                                << query_min_cluster_size;
+    }
+
     // constant variables
     const double fraction_kmers_required_for_cluster = 0.5 / exp(e_rate * k);
     const uint32_t nb_reads_to_map_in_a_batch = 1000; // nb of reads to map in a batch
 
-    // shared variable - controlled by critical(covg)
+    const bool subsample_reads = subsample_fraction < 1;
+    if (subsample_reads) {
+        BOOST_LOG_TRIVIAL(info) << "Subsampling " << subsample_fraction
+                                << " of the reads";
+    }
+
+    // shared variables - updated atomically
+    uint64_t number_of_hits { 0 };
+    uint64_t number_of_hits_kept { 0 };
+
+    // shared variables - controlled by critical(covg)
     uint64_t covg { 0 };
 
     // shared variables - controlled by critical(ReadFileMutex)
     FastaqHandler fh(filepath);
     uint32_t id { 0 };
+    // bases of the reads read so far, used to stop at target_covg. Reads are read in
+    // file order, so the reads mapped do not depend on the number of threads
+    uint64_t bases_read { 0 };
+    bool target_covg_reached { false };
 
 // parallel region
 #pragma omp parallel num_threads(threads)
     {
         // will hold the reads batch
         std::vector<Seq> sequencesBuffer(
-            nb_reads_to_map_in_a_batch, Seq(0, "null", "", w, k));
+            nb_reads_to_map_in_a_batch, Seq(0, "null", "", query_w, k, syncmer_size));
         while (true) {
             // read the next batch of reads
             uint32_t nbOfReads = 0;
@@ -433,17 +834,41 @@ uint32_t pangraph_from_read_file(const std::string& filepath,
 #pragma omp critical(ReadFileMutex)
             {
                 for (auto& sequence : sequencesBuffer) {
+                    if (target_covg_reached) {
+                        break; // the reads read so far reached target_covg
+                    }
                     if (id && id % 100000 == 0) {
                         BOOST_LOG_TRIVIAL(info) << id << " reads processed...";
                     }
                     try {
-                        fh.get_next();
+                        fh.get_next_view();
                     } catch (std::out_of_range& err) {
                         break;
                     }
-                    sequence.initialize(id, fh.name, fh.read, w, k);
+                    // reads left out by subsampling are not sketched, but keep their
+                    // id, so that ids still match the read positions in the file
+                    if (subsample_reads
+                        and !read_is_kept_when_subsampling(
+                            fh.name_view, subsample_fraction)) {
+                        sequence.initialize(
+                            id, fh.name_view, "", query_w, k, syncmer_size);
+                    } else {
+                        sequence.initialize(id, fh.name_view, fh.read_view, query_w, k,
+                            syncmer_size);
+                    }
                     ++nbOfReads;
                     ++id;
+
+                    if (target_covg > 0 and !sequence.sketch.empty()) {
+                        bases_read += sequence.seq.length();
+                        if (bases_read / genome_size >= target_covg) {
+                            BOOST_LOG_TRIVIAL(info)
+                                << "Stop reading reads as the estimated coverage has "
+                                   "reached "
+                                << target_covg << " after " << id << " reads";
+                            target_covg_reached = true;
+                        }
+                    }
                 }
             }
 
@@ -459,7 +884,7 @@ uint32_t pangraph_from_read_file(const std::string& filepath,
                 if (!sequence.sketch.empty()) {
 #pragma omp critical(covg)
                     {
-                        // check if the max_covg was already exceeded
+                        // check if the max_covg was already reached
                         if (covg / genome_size > max_covg) {
                             // if reached here, it means that another thread realised
                             // that we went past the max_covg, so we just exit
@@ -484,17 +909,29 @@ uint32_t pangraph_from_read_file(const std::string& filepath,
                     continue;
                 }
 
-                const auto expected_number_kmers_in_read_sketch { sequence.seq.length()
-                    * 2 / (w + 1) };
+                const auto expected_number_kmers_in_read_sketch {
+                    get_expected_number_kmers_in_read_sketch(
+                        sequence.seq.length(), query_w, k, syncmer_size)
+                };
 
                 // get the minizer hits
                 auto minimizer_hits = std::make_shared<MinimizerHits>(MinimizerHits());
-                add_read_hits(sequence, minimizer_hits, *index);
+                const uint64_t number_of_hits_of_read = add_read_hits(sequence,
+                    minimizer_hits, *index, prgs, query_min_cluster_size,
+                    expected_number_kmers_in_read_sketch,
+                    fraction_kmers_required_for_cluster, query_sketch_density_ratio);
+                const uint64_t number_of_hits_kept_of_read
+                    = minimizer_hits->hits.size();
+#pragma omp atomic
+                number_of_hits += number_of_hits_of_read;
+#pragma omp atomic
+                number_of_hits_kept += number_of_hits_kept_of_read;
 
                 // infer
                 infer_localPRG_order_for_reads(prgs, minimizer_hits, pangraph, max_diff,
-                    genome_size, fraction_kmers_required_for_cluster, min_cluster_size,
-                    expected_number_kmers_in_read_sketch);
+                    genome_size, fraction_kmers_required_for_cluster,
+                    query_min_cluster_size, expected_number_kmers_in_read_sketch,
+                    query_sketch_density_ratio);
             }
 
             if (coverageExceeded)
@@ -502,6 +939,10 @@ uint32_t pangraph_from_read_file(const std::string& filepath,
         }
     }
     BOOST_LOG_TRIVIAL(info) << "Processed " << id << " reads";
+    BOOST_LOG_TRIVIAL(info) << "Kept " << number_of_hits_kept << " of the "
+                            << number_of_hits
+                            << " minimizer hits, discarding those on (read, locus, "
+                               "strand) pairs with too few hits to form a cluster";
 
     BOOST_LOG_TRIVIAL(debug) << "Pangraph has " << pangraph->nodes.size() << " nodes";
 
@@ -509,11 +950,13 @@ uint32_t pangraph_from_read_file(const std::string& filepath,
     BOOST_LOG_TRIVIAL(debug) << "Estimated coverage: " << covg;
 
     if (illumina and clean) {
-        clean_pangraph_with_debruijn_graph(pangraph, 2, 1, illumina);
+        clean_pangraph_with_debruijn_graph(
+            pangraph, 2, 1, illumina, clean_by_component, threads);
         BOOST_LOG_TRIVIAL(debug)
             << "After cleaning, pangraph has " << pangraph->nodes.size() << " nodes";
     } else if (clean) {
-        clean_pangraph_with_debruijn_graph(pangraph, 3, 1, illumina);
+        clean_pangraph_with_debruijn_graph(
+            pangraph, 3, 1, illumina, clean_by_component, threads);
         BOOST_LOG_TRIVIAL(debug)
             << "After cleaning, pangraph has " << pangraph->nodes.size() << " nodes";
     }
@@ -521,6 +964,23 @@ uint32_t pangraph_from_read_file(const std::string& filepath,
     return covg;
 }
 
+bool read_is_kept_when_subsampling(
+    boost::string_ref read_name, const float subsample_fraction)
+{
+    // 64-bit FNV-1a of the name, mixed with hash64, so that the decision only depends
+    // on the read name and not on the order or batch in which reads are processed
+    uint64_t name_hash = 14695981039346656037ULL;
+    for (const char c : read_name) {
+        name_hash ^= (uint8_t)c;
+        name_hash *= 1099511628211ULL;
+    }
+    name_hash = hash64(name_hash, std::numeric_limits<uint64_t>::max());
+
+    const double hash_as_fraction
+        = (double)name_hash / (double)std::numeric_limits<uint64_t>::max();
+    return hash_as_fraction < subsample_fraction;
+}
+
 void open_file_for_reading(const std::string& file_path, std::ifstream& stream)
 {
     stream.open(file_path);
@@ -593,6 +1053,18 @@ std::string transform_cli_gsize(std::string str)
 
 std::string make_absolute(std::string str) { return fs::absolute(str).string(); }
 
+SampleFpath join_read_filepaths(const std::vector<fs::path>& read_filepaths)
+{
+    SampleFpath joined_filepaths;
+    for (const auto& read_filepath : read_filepaths) {
+        if (!joined_filepaths.empty()) {
+            joined_filepaths += ",";
+        }
+        joined_filepaths += read_filepath.string();
+    }
+    return joined_filepaths;
+}
+
 std::vector<std::pair<SampleIdText, SampleFpath>> load_read_index(
     const fs::path& read_index_fpath)
 {
@@ -7,6 +7,15 @@ void VCF::add_record_core(const VCFRecord& vr)
         vr.get_pos(), vr.get_ref_end_pos(), records.back().get());
 }
 
+void VCF::rebuild_record_interval_trees()
+{
+    chrom_to_record_interval_tree.clear();
+    for (const auto& record : records) {
+        chrom_to_record_interval_tree[record->get_chrom()].add(
+            record->get_pos(), record->get_ref_end_pos(), record.get());
+    }
+}
+
 void VCF::add_record(const std::string& chrom, uint32_t position,
     const std::string& ref, const std::string& alt, const std::string& info,
     const std::string& graph_type_info)
@@ -234,6 +243,16 @@ void VCF::sort_records()
             const std::shared_ptr<VCFRecord>& rhs) { return (*lhs) < (*rhs); });
 }
 
+void VCF::sort_records_if_unsorted()
+{
+    const bool records_are_sorted = std::is_sorted(records.begin(), records.end(),
+        [](const std::shared_ptr<VCFRecord>& lhs,
+            const std::shared_ptr<VCFRecord>& rhs) { return (*lhs) < (*rhs); });
+    if (!records_are_sorted) {
+        sort_records();
+    }
+}
+
 bool VCF::pos_in_range(
     const uint32_t from, const uint32_t to, const std::string& chrom) const
 {
@@ -384,9 +403,124 @@ VCF VCF::correct_dot_alleles(const std::string& vcf_ref, const std::string& chro
     return vcf_with_dot_alleles_corrected;
 }
 
+void VCF::merge_multi_allelic_in_place(uint32_t max_allele_length)
+{
+    const size_t vcf_size = records.size();
+    const bool no_need_for_merging = vcf_size <= 1;
+    if (no_need_for_merging) {
+        return;
+    }
+
+    // records are merged into the previous one only, so if no pair of consecutive
+    // records can be merged, the merge is a no-op apart from sorting
+    auto first_record_to_be_merged_in = records.begin() + 1;
+    for (; first_record_to_be_merged_in != records.end();
+         ++first_record_to_be_merged_in) {
+        const bool vcf_record_should_be_merged_in
+            = (*(first_record_to_be_merged_in - 1))
+                  ->can_biallelic_record_be_merged_into_this(
+                      **first_record_to_be_merged_in, max_allele_length);
+        if (vcf_record_should_be_merged_in) {
+            break;
+        }
+    }
+    const bool no_record_is_merged = first_record_to_be_merged_in == records.end();
+    if (no_record_is_merged) {
+        sort_records_if_unsorted();
+        return;
+    }
+
+    std::vector<std::shared_ptr<VCFRecord>> merged_records;
+    merged_records.reserve(vcf_size);
+    std::move(records.begin(), first_record_to_be_merged_in,
+        std::back_inserter(merged_records));
+    for (auto record_it = first_record_to_be_merged_in; record_it != records.end();
+         ++record_it) {
+        VCFRecord& vcf_record_merged = *merged_records.back();
+        const bool vcf_record_should_be_merged_in
+            = vcf_record_merged.can_biallelic_record_be_merged_into_this(
+                **record_it, max_allele_length);
+        if (vcf_record_should_be_merged_in) {
+            vcf_record_merged.merge_record_into_this(**record_it);
+        } else {
+            merged_records.push_back(std::move(*record_it));
+        }
+    }
+    records = std::move(merged_records);
+
+    sort_records();
+    rebuild_record_interval_trees();
+}
+
+void VCF::correct_dot_alleles_in_place(
+    const std::string& vcf_ref, const std::string& chrom)
+{
+    // NB need to merge multiallelic before
+    // NB cannot add covgs after
+    const bool no_record_contains_dot_allele = std::none_of(records.begin(),
+        records.end(), [&chrom](const std::shared_ptr<VCFRecord>& record) {
+            return record->get_chrom() == chrom and record->contains_dot_allele();
+        });
+    if (no_record_contains_dot_allele) {
+        sort_records_if_unsorted();
+        return;
+    }
+
+    const size_t vcf_size = records.size();
+    std::vector<std::shared_ptr<VCFRecord>> corrected_records;
+    corrected_records.reserve(vcf_size);
+    for (auto& record_pointer : records) {
+        VCFRecord& record = *record_pointer;
+
+        const bool we_are_in_the_given_chrom = record.get_chrom() == chrom;
+        if (we_are_in_the_given_chrom and record.contains_dot_allele()) {
+            const bool record_pos_refers_to_an_existing_pos_in_vcf_ref
+                = vcf_ref.length() >= record.get_pos();
+            if (!record_pos_refers_to_an_existing_pos_in_vcf_ref) {
+                fatal_error("When correcting dot alleles, a VCF record has an "
+                            "inexistent position (",
+                    record.get_pos(), ") in VCF ref with length ", vcf_ref.length());
+            }
+            const bool there_is_a_previous_letter = record.get_pos() > 0;
+            const bool there_is_a_next_letter
+                = record.get_pos() + record.get_ref().length() + 1 < vcf_ref.length();
+            if (there_is_a_previous_letter) {
+                char prev_letter = vcf_ref[record.get_pos() - 1];
+                record.correct_dot_alleles_adding_nucleotide_before(prev_letter);
+            } else if (there_is_a_next_letter) {
+                char next_letter;
+                if (record.allele_is_dot(record.get_ref())) {
+                    next_letter = vcf_ref[record.get_pos()];
+                } else {
+                    next_letter = vcf_ref[record.get_pos() + record.get_ref().length()];
+                }
+                record.correct_dot_alleles_adding_nucleotide_after(next_letter);
+            } else {
+                // could not be corrected, drop it
+                continue;
+            }
+        }
+
+        // a corrected record might now be equal to another one, same as add_record()
+        const bool record_is_new
+            = std::find_if(corrected_records.begin(), corrected_records.end(),
+                  [&record](const std::shared_ptr<VCFRecord>& other) {
+                      return *other == record;
+                  })
+            == corrected_records.end();
+        if (record_is_new) {
+            corrected_records.push_back(std::move(record_pointer));
+        }
+    }
+    records = std::move(corrected_records);
+
+    sort_records();
+    rebuild_record_interval_trees();
+}
+
 void VCF::make_gt_compatible()
 {
-    BOOST_LOG_TRIVIAL(info) << now() << "Make all genotypes compatible";
+    BOOST_LOG_TRIVIAL(debug) << now() << "Make all genotypes compatible";
 
     for (auto& recordPointer : records) {
         VCFRecord& record = *recordPointer;
@@ -1693,6 +1693,82 @@ TEST(ConstructPileupConstructionMapTest,
     compare_maps(actual, expected);
 }
 
+TEST(CandidateRegionCostTest, sortByDecreasingCost_tiesKeepTheirOrder)
+{
+    // costs (pileup size times interval length) of 2, 6, 2 and 9
+    CandidateRegion region_1 { Interval(0, 2), "region_1" };
+    region_1.pileup = { "A" };
+    CandidateRegion region_2 { Interval(0, 3), "region_2" };
+    region_2.pileup = { "A", "C" };
+    CandidateRegion region_3 { Interval(0, 1), "region_3" };
+    region_3.pileup = { "A", "C" };
+    CandidateRegion region_4 { Interval(0, 3), "region_4" };
+    region_4.pileup = { "A", "C", "G" };
+    std::vector<CandidateRegion*> candidate_regions { &region_1, &region_2, &region_3,
+        &region_4 };
+
+    Discover::sort_candidate_regions_by_decreasing_cost(candidate_regions);
+
+    const std::vector<CandidateRegion*> expected { &region_4, &region_2, &region_1,
+        &region_3 };
+    EXPECT_EQ(candidate_regions, expected);
+}
+
+class CandidateRegionWavesTest : public ::testing::Test {
+protected:
+    CandidateRegions candidate_regions;
+    const uint64_t pileup_memory_of_each_region { sizeof(std::string) + 100 };
+
+    void SetUp() override
+    {
+        for (uint32_t i = 0; i < 3; ++i) {
+            CandidateRegion candidate { Interval(0, 3), "test" + std::to_string(i) };
+            candidate.read_coordinates.insert(ReadCoordinate { i, 50, 150, true });
+            candidate_regions.insert(std::make_pair(candidate.get_id(), candidate));
+        }
+    }
+
+    static std::vector<size_t> get_wave_sizes(
+        const std::vector<std::vector<CandidateRegion*>>& waves)
+    {
+        std::vector<size_t> wave_sizes;
+        for (const auto& wave : waves)
+            wave_sizes.push_back(wave.size());
+        return wave_sizes;
+    }
+};
+
+TEST_F(CandidateRegionWavesTest, estimatedPileupMemory)
+{
+    for (const auto& element : candidate_regions)
+        EXPECT_EQ(
+            element.second.get_estimated_pileup_memory(), pileup_memory_of_each_region);
+}
+
+TEST_F(CandidateRegionWavesTest, noLimit_OneWave)
+{
+    const auto waves = Discover::get_candidate_region_waves(candidate_regions, 0);
+    EXPECT_EQ(get_wave_sizes(waves), std::vector<size_t>({ 3 }));
+}
+
+TEST_F(CandidateRegionWavesTest, limitOfTwoRegions_TwoWaves)
+{
+    const auto waves = Discover::get_candidate_region_waves(
+        candidate_regions, 2 * pileup_memory_of_each_region);
+    EXPECT_EQ(get_wave_sizes(waves), std::vector<size_t>({ 2, 1 }));
+}
+
+TEST_F(CandidateRegionWavesTest, limitBelowOneRegion_OneWavePerRegion)
+{
+    const auto waves = Discover::get_candidate_region_waves(candidate_regions, 10);
+    EXPECT_EQ(get_wave_sizes(waves), std::vector<size_t>({ 1, 1, 1 }));
+
+    std::set<CandidateRegion*> regions_in_waves;
+    for (const auto& wave : waves)
+        regions_in_waves.insert(wave.begin(), wave.end());
+    EXPECT_EQ(regions_in_waves.size(), candidate_regions.size());
+}
+
 TEST(SimpleDenovoVariantRecord, creation_and_to_string)
 {
     SimpleDenovoVariantRecord record(10, "ACCG---T", "A---TTTG");
@@ -1821,6 +1897,21 @@ TEST_F(CandidateRegionWriteBuffer___Fixture, write_to_file_core)
     EXPECT_EQ(actual, expected);
 }
 
+TEST_F(CandidateRegionWriteBuffer___Fixture, write_to_file_core_variantsSorted)
+{
+    CandidateRegionWriteBufferMock buffer { "test_sample" };
+    buffer.add_new_variant("locus_1", "ml_path_1", "var_2");
+    buffer.add_new_variant("locus_1", "ml_path_1", "var_1");
+
+    std::stringstream ss;
+    buffer.write_to_file_core(ss);
+
+    std::string expected
+        = "Sample test_sample\n1 loci with denovo variants\nlocus_1\nml_path_1\n2 "
+          "denovo variants for this locus\nvar_1\nvar_2\n";
+    EXPECT_EQ(ss.str(), expected);
+}
+
 // NB: we can always assume we have some flanking sequences between the denovo sequence
 // and the ML sequence for these tests
 class CandidateRegion___get_variants___Fixture : public ::testing::Test {
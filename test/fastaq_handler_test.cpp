@@ -18,14 +18,14 @@ TEST(FastaqHandlerTest, create_fa)
     FastaqHandler fh(TEST_CASE_DIR + "reads.fa");
     EXPECT_EQ((uint32_t)0, fh.num_reads_parsed);
 
-    EXPECT_TRUE(fh.fastaq_file);
+    EXPECT_TRUE(fh.is_memory_mapped());
 }
 
 TEST(FastaqHandlerTest, create_fq)
 {
     FastaqHandler fh(TEST_CASE_DIR + "reads.fq");
     EXPECT_EQ((uint)0, fh.num_reads_parsed);
-    EXPECT_TRUE(fh.fastaq_file);
+    EXPECT_TRUE(fh.is_memory_mapped());
 }
 
 TEST(FastaqHandlerTest, create_fagz)
@@ -33,6 +33,7 @@ TEST(FastaqHandlerTest, create_fagz)
     FastaqHandler fh(TEST_CASE_DIR + "reads.fa.gz");
     EXPECT_EQ((uint)0, fh.num_reads_parsed);
     EXPECT_TRUE(fh.fastaq_file);
+    EXPECT_FALSE(fh.is_memory_mapped());
 }
 
 TEST(FastaqHandlerTest, create_fqgz)
@@ -40,6 +41,7 @@ TEST(FastaqHandlerTest, create_fqgz)
     FastaqHandler fh(TEST_CASE_DIR + "reads.fq.gz");
     EXPECT_EQ((uint)0, fh.num_reads_parsed);
     EXPECT_TRUE(fh.fastaq_file);
+    EXPECT_FALSE(fh.is_memory_mapped());
 }
 
 TEST(FastaqHandlerTest, get_next)
@@ -274,18 +276,20 @@ TEST(FastaqHandlerTest, close)
 {
     FastaqHandler fh(TEST_CASE_DIR + "reads.fa");
     EXPECT_EQ((uint32_t)0, fh.num_reads_parsed);
-    EXPECT_TRUE(fh.fastaq_file);
+    EXPECT_TRUE(fh.is_memory_mapped());
     fh.close();
     EXPECT_TRUE(fh.is_closed());
+    EXPECT_FALSE(fh.is_memory_mapped());
 }
 
 TEST(FastaqHandlerTest, close_multiple_times_does_not_error)
 {
     FastaqHandler fh(TEST_CASE_DIR + "reads.fa");
     EXPECT_EQ((uint32_t)0, fh.num_reads_parsed);
-    EXPECT_TRUE(fh.fastaq_file);
+    EXPECT_TRUE(fh.is_memory_mapped());
     fh.close();
     EXPECT_TRUE(fh.is_closed());
+    EXPECT_FALSE(fh.is_memory_mapped());
     fh.close();
     fh.close();
 }
@@ -316,4 +320,131 @@ TEST(FastaqHandlerTest, get_next_on_empty_file_throws_exception)
     FastaqHandler fh(filepath);
     EXPECT_FALSE(fh.eof());
     EXPECT_THROW(fh.get_next(), std::out_of_range);
-}
\ No newline at end of file
+}
+TEST(FastaqHandlerTest, split_filepaths_ignores_empty_entries)
+{
+    const std::vector<std::string> expected { "a.fq", "b.fq.gz" };
+    EXPECT_EQ(expected, FastaqHandler::split_filepaths("a.fq,,b.fq.gz,"));
+}
+
+TEST(FastaqHandlerTest, split_filepaths_keeps_existing_file_with_comma_whole)
+{
+    const std::string filepath = std::string(std::tmpnam(nullptr)) + ",reads.fa";
+    {
+        std::ofstream outstream(filepath);
+        outstream << ">read\nACGT\n";
+    }
+
+    const std::vector<std::string> expected { filepath };
+    EXPECT_EQ(expected, FastaqHandler::split_filepaths(filepath));
+
+    FastaqHandler fh(filepath);
+    fh.get_next();
+    EXPECT_EQ(fh.name, "read");
+    EXPECT_EQ(fh.read, "ACGT");
+
+    std::remove(filepath.c_str());
+}
+
+TEST(FastaqHandlerTest, get_next_multiple_files_keeps_counting_reads)
+{
+    FastaqHandler fh(TEST_CASE_DIR + "read2.fa," + TEST_CASE_DIR + "reads.fq.gz");
+    fh.get_next();
+    fh.get_next();
+    EXPECT_EQ((uint32_t)2, fh.num_reads_parsed);
+    EXPECT_EQ(fh.name, "read2_prime");
+    EXPECT_FALSE(fh.eof());
+
+    fh.get_next();
+    EXPECT_EQ((uint32_t)3, fh.num_reads_parsed);
+    EXPECT_EQ(fh.name, "read0");
+    EXPECT_EQ(fh.read, "to be ignored");
+    EXPECT_EQ(TEST_CASE_DIR + "reads.fq.gz", fh.filepath);
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        fh.get_next();
+    }
+    EXPECT_EQ((uint32_t)7, fh.num_reads_parsed);
+    EXPECT_EQ(fh.name, "read4");
+    EXPECT_THROW(fh.get_next(), std::out_of_range);
+}
+
+TEST(FastaqHandlerTest, get_next_multiple_files_skips_empty_file)
+{
+    const std::string filepath = std::tmpnam(nullptr);
+    {
+        std::ofstream outstream(filepath);
+        outstream << "";
+    }
+
+    FastaqHandler fh(std::vector<std::string> { filepath, TEST_CASE_DIR + "reads.fa" });
+    fh.get_next();
+    EXPECT_EQ((uint32_t)1, fh.num_reads_parsed);
+    EXPECT_EQ(fh.name, "read0");
+}
+
+TEST(FastaqHandlerTest, get_nth_read_multiple_files_rewinds_to_first_file)
+{
+    FastaqHandler fh(TEST_CASE_DIR + "read2.fa," + TEST_CASE_DIR + "reads.fa");
+
+    fh.get_nth_read(3);
+    EXPECT_EQ((uint32_t)4, fh.num_reads_parsed);
+    EXPECT_EQ(fh.name, "read1");
+    EXPECT_EQ(fh.read, "should copy the phrase *should*");
+
+    fh.get_nth_read(1);
+    EXPECT_EQ((uint32_t)2, fh.num_reads_parsed);
+    EXPECT_EQ(fh.name, "read2_prime");
+    EXPECT_EQ(TEST_CASE_DIR + "read2.fa", fh.filepath);
+
+    fh.get_nth_read(6);
+    EXPECT_EQ((uint32_t)7, fh.num_reads_parsed);
+    EXPECT_EQ(fh.name, "read4");
+    EXPECT_THROW(fh.get_nth_read(7), std::out_of_range);
+}
+
+TEST(FastaqHandlerTest, get_next_view_mapped_and_gzipped_files_give_same_records)
+{
+    FastaqHandler mapped_fh(TEST_CASE_DIR + "reads.fq");
+    FastaqHandler gzipped_fh(TEST_CASE_DIR + "reads.fq.gz");
+    ASSERT_TRUE(mapped_fh.is_memory_mapped());
+    ASSERT_FALSE(gzipped_fh.is_memory_mapped());
+
+    for (uint32_t i = 0; i < 5; ++i) {
+        mapped_fh.get_next_view();
+        gzipped_fh.get_next_view();
+        EXPECT_EQ(mapped_fh.name_view, gzipped_fh.name_view);
+        EXPECT_EQ(mapped_fh.read_view, gzipped_fh.read_view);
+    }
+    EXPECT_EQ(mapped_fh.num_reads_parsed, gzipped_fh.num_reads_parsed);
+    EXPECT_THROW(mapped_fh.get_next_view(), std::out_of_range);
+}
+
+TEST(FastaqHandlerTest, get_next_mapped_multiline_fasta_and_crlf)
+{
+    const std::string filepath = std::tmpnam(nullptr);
+    {
+        std::ofstream outstream(filepath);
+        outstream << "some junk\n>read1 comment\r\nACGT\r\nTTAA\r\n\r\n";
+        outstream << ">read2\nGGCC\n@read3\tcomment\nAC\nGT\n+read3\n^^\n^^\n";
+    }
+
+    FastaqHandler fh(filepath);
+    ASSERT_TRUE(fh.is_memory_mapped());
+    fh.get_next();
+    EXPECT_EQ(fh.name, "read1");
+    EXPECT_EQ(fh.read, "ACGTTTAA");
+    fh.get_next();
+    EXPECT_EQ(fh.name, "read2");
+    EXPECT_EQ(fh.read, "GGCC");
+    EXPECT_FALSE(fh.eof());
+    fh.get_next();
+    EXPECT_EQ(fh.name, "read3");
+    EXPECT_EQ(fh.read, "ACGT");
+    EXPECT_TRUE(fh.eof());
+    EXPECT_EQ((uint32_t)3, fh.num_reads_parsed);
+
+    fh.get_nth_read(1);
+    EXPECT_EQ(fh.name, "read2");
+    EXPECT_EQ(fh.read, "GGCC");
+}
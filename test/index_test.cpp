@@ -5,6 +5,7 @@
 #include "interval.h"
 #include "inthash.h"
 #include "utils.h"
+#include "test_helpers.h"
 #include <vector>
 #include <stdint.h>
 #include <iostream>
@@ -105,6 +106,80 @@ TEST(IndexTest, load)
         idx2.minhash[min(kh2.first, kh2.second)]->at(0));
 }
 
+TEST(IndexTest, load_onlyGivenPrgIds)
+{
+    Index idx1, idx2;
+    KmerHash hash;
+    deque<Interval> d = { Interval(3, 5), Interval(9, 12) };
+    prg::Path p;
+    p.initialize(d);
+    pair<uint64_t, uint64_t> kh1 = hash.kmerhash("ACGTA", 5);
+    idx1.add_record(min(kh1.first, kh1.second), 1, p, 0, 0);
+    idx1.add_record(min(kh1.first, kh1.second), 4, p, 0, 0);
+
+    // the records of prg 2 are not loaded, and neither is its minimizer
+    idx2.load("indextext", 1, 5, { 1, 4 });
+    EXPECT_EQ(idx1, idx2);
+    EXPECT_EQ(idx2.minhash.size(), (uint)1);
+    EXPECT_EQ(idx2.minhash[min(kh1.first, kh1.second)]->size(), (uint)2);
+}
+
+TEST(IndexTest, saveAndLoad_syncmerSizeIsKept)
+{
+    Index idx1, idx2;
+    KmerHash hash;
+    deque<Interval> d = { Interval(3, 5), Interval(9, 12) };
+    prg::Path p;
+    p.initialize(d);
+    pair<uint64_t, uint64_t> kh = hash.kmerhash("ACGTA", 5);
+    idx1.add_record(min(kh.first, kh.second), 1, p, 0, 0);
+    idx1.syncmer_size = 3;
+    idx1.window_size = 1;
+    idx1.save("indextext_syncmer", 1, 5);
+
+    idx2.load("indextext_syncmer", 1, 5);
+    EXPECT_EQ(idx2.syncmer_size, (uint)3);
+    EXPECT_EQ(idx2.window_size, (uint)1);
+    EXPECT_EQ(idx1, idx2);
+
+    idx2.syncmer_size = 0;
+    EXPECT_NE(idx1, idx2);
+}
+
+TEST(IndexTest, load_differentSyncmerSizes___expects_FatalRuntimeError)
+{
+    Index idx1, idx2;
+    KmerHash hash;
+    deque<Interval> d = { Interval(3, 5), Interval(9, 12) };
+    prg::Path p;
+    p.initialize(d);
+    pair<uint64_t, uint64_t> kh = hash.kmerhash("ACGTA", 5);
+    idx1.add_record(min(kh.first, kh.second), 1, p, 0, 0);
+    idx1.syncmer_size = 3;
+    idx1.save("indextext_syncmer", 1, 5);
+
+    idx2.add_record(min(kh.first, kh.second), 2, p, 0, 0);
+    ASSERT_EXCEPTION(idx2.load("indextext_syncmer", 1, 5), FatalRuntimeError,
+        "Only indices sketched the same way can be merged");
+}
+
+TEST(IndexTest, load_syncmerIndexBuiltWithAnotherWindowSize___expects_FatalRuntimeError)
+{
+    Index idx1, idx2;
+    KmerHash hash;
+    deque<Interval> d = { Interval(3, 5), Interval(9, 12) };
+    prg::Path p;
+    p.initialize(d);
+    pair<uint64_t, uint64_t> kh = hash.kmerhash("ACGTA", 5);
+    idx1.add_record(min(kh.first, kh.second), 1, p, 0, 0);
+    idx1.syncmer_size = 3;
+    idx1.window_size = 2;
+    idx1.save(fs::path("indextext_syncmer.k5.w1.idx"));
+
+    ASSERT_EXCEPTION(idx2.load("indextext_syncmer", 1, 5), FatalRuntimeError,
+        "which must also be the window size given (1)");
+}
+
 TEST(IndexTest, equals)
 {
     Index idx1, idx2;
@@ -184,3 +259,21 @@ TEST(IndexTest, merging_indexes)
     read_prg_file(prgs, TEST_CASE_DIR + "prg0123.fa");
     index_prgs(prgs, index_all, w, k, outdir);
 }
+
+TEST(IndexTest, indexPrgs_vcfSitesSavedOnlyWhenAsked)
+{
+    uint32_t w = 2, k = 3;
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+    auto index = std::make_shared<Index>();
+    const fs::path outdir { TEST_CASE_DIR + "vcf_sites_kgs/" };
+    const fs::path vcf_sites_file { outdir / "01" / "prg1.vcf_sites" };
+    read_prg_file(prgs, TEST_CASE_DIR + "prg1.fa");
+
+    index_prgs(prgs, index, w, k, outdir);
+    EXPECT_FALSE(fs::exists(vcf_sites_file));
+
+    index->clear();
+    index_prgs(prgs, index, w, k, outdir, 1, 0, true);
+    EXPECT_TRUE(fs::exists(vcf_sites_file));
+    fs::remove_all(outdir);
+}
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+#include "kmer_hashing.h"
+#include "inthash.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace {
+vector<KmerHashingKernel> get_supported_kernels()
+{
+    vector<KmerHashingKernel> kernels;
+    for (const auto kernel : { KmerHashingKernel::scalar, KmerHashingKernel::sse2,
+             KmerHashingKernel::avx2 }) {
+        if (kmer_hashing_kernel_is_supported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+    return kernels;
+}
+
+vector<uint64_t> get_random_kmers(const size_t number_of_kmers, const uint64_t mask)
+{
+    std::mt19937_64 generator(42);
+    vector<uint64_t> kmers(number_of_kmers);
+    for (auto& kmer : kmers) {
+        kmer = generator() & mask;
+    }
+    return kmers;
+}
+}
+
+TEST(KmerHashingTest, scalarKernel_isAlwaysSupported)
+{
+    EXPECT_TRUE(kmer_hashing_kernel_is_supported(KmerHashingKernel::scalar));
+    EXPECT_TRUE(kmer_hashing_kernel_is_supported(get_best_kmer_hashing_kernel()));
+}
+
+TEST(KmerHashingTest, allKernels_sameHashesAsHash64)
+{
+    for (const uint32_t k : { 1, 7, 15, 21, 31, 32 }) {
+        const uint64_t mask = k == 32 ? UINT64_MAX : (1ULL << 2 * k) - 1;
+        // sizes that are not multiples of the number of lanes exercise the tails
+        for (const size_t number_of_kmers : { 0, 1, 2, 3, 4, 5, 7, 8, 13, 100 }) {
+            const vector<uint64_t> kmers = get_random_kmers(number_of_kmers, mask);
+            vector<uint64_t> expected;
+            for (const auto kmer : kmers) {
+                expected.push_back(hash64(kmer, mask));
+            }
+
+            for (const auto kernel : get_supported_kernels()) {
+                vector<uint64_t> hashes(number_of_kmers);
+                hash_kmers(kmers.data(), hashes.data(), number_of_kmers, mask, kernel);
+                EXPECT_EQ(hashes, expected) << to_string(kernel) << " k=" << k;
+            }
+        }
+    }
+}
+
+TEST(KmerHashingTest, hashInPlace_sameHashesAsHash64)
+{
+    const uint64_t mask = (1ULL << 2 * 15) - 1;
+    const vector<uint64_t> kmers = get_random_kmers(11, mask);
+    for (const auto kernel : get_supported_kernels()) {
+        vector<uint64_t> hashes(kmers);
+        hash_kmers(hashes.data(), hashes.data(), hashes.size(), mask, kernel);
+        for (size_t i = 0; i < kmers.size(); ++i) {
+            EXPECT_EQ(hashes[i], hash64(kmers[i], mask)) << to_string(kernel);
+        }
+    }
+}
+
+// microbenchmark, run with --gtest_also_run_disabled_tests
+TEST(KmerHashingTest, DISABLED_benchmark_hashesPerSecond)
+{
+    const uint64_t mask = (1ULL << 2 * 15) - 1;
+    const size_t number_of_kmers = 1 << 20;
+    const uint32_t repetitions = 100;
+    const vector<uint64_t> kmers = get_random_kmers(number_of_kmers, mask);
+    vector<uint64_t> hashes(number_of_kmers);
+
+    for (const auto kernel : get_supported_kernels()) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < repetitions; ++i) {
+            hash_kmers(kmers.data(), hashes.data(), number_of_kmers, mask, kernel);
+        }
+        const std::chrono::duration<double> elapsed
+            = std::chrono::steady_clock::now() - start;
+        std::cout << to_string(kernel) << ": "
+                  << (number_of_kmers * repetitions) / elapsed.count()
+                  << " hashes per second" << std::endl;
+    }
+}
@@ -54,6 +54,25 @@ TEST(KmerGraphTest, add_node)
     EXPECT_EQ(j, kg.nodes[1]->id);
 }
 
+TEST(KmerGraphTest, add_node_after_copy_and_clear_finds_existing_nodes)
+{
+    KmerGraph kg;
+    prg::Path p1, p2;
+    p1.initialize(deque<Interval> { Interval(0, 3) });
+    p2.initialize(deque<Interval> { Interval(1, 2), Interval(5, 7) });
+    kg.add_node(p1);
+    kg.add_node(p2);
+
+    KmerGraph copied_kg(kg);
+    EXPECT_EQ(copied_kg.nodes[1], copied_kg.add_node(p2));
+    EXPECT_EQ((uint)2, copied_kg.nodes.size());
+
+    kg.clear();
+    kg.add_node(p2);
+    EXPECT_EQ((uint)0, kg.add_node(p2)->id);
+    EXPECT_EQ((uint)1, kg.nodes.size());
+}
+
 TEST(KmerGraphTest, add_node_with_kh)
 {
     // add node and check it's there
@@ -349,6 +368,32 @@ TEST(KmerGraphTest, check)
     kg.check();
 }
 
+TEST(KmerGraphTest, check_selfLoop___expects_FatalRuntimeError)
+{
+    KmerGraph kg;
+    std::deque<Interval> d = { Interval(0, 0) };
+    prg::Path p;
+    p.initialize(d);
+    kg.add_node(p);
+    d = { Interval(0, 3) };
+    p.initialize(d);
+    kg.add_node(p);
+    d = { Interval(3, 3) };
+    p.initialize(d);
+    kg.add_node(p);
+    kg.add_edge(kg.nodes[0], kg.nodes[1]);
+    kg.add_edge(kg.nodes[1], kg.nodes[2]);
+    kg.sorted_nodes = { kg.nodes[0], kg.nodes[1], kg.nodes[2] };
+    kg.check();
+
+    // add_edge refuses self-loops, so this one is added by hand. As a node does occur
+    // from itself onwards in the topological order, the self-loop is rejected because
+    // the path of the node is not less than itself
+    kg.nodes[1]->out_nodes.push_back(kg.nodes[1]);
+    kg.nodes[1]->in_nodes.push_back(kg.nodes[1]);
+    ASSERT_EXCEPTION(kg.check(), FatalRuntimeError, "(invalid neighbour path order)");
+}
+
 TEST(KmerGraphTest, remove_shortcut_edges)
 {
     auto index = std::make_shared<Index>();
@@ -8,6 +8,7 @@
 #include <stdint.h>
 #include <iostream>
 #include <cmath>
+#include <limits>
 #include "test_helpers.h"
 
 using namespace prg;
@@ -171,6 +172,36 @@ TEST(KmerGraphWithCoverageTest, minimumCoverageSet)
         kmergraph_with_coverage, expected_coverage, nb_of_nodes, nb_of_samples);
 }
 
+TEST(KmerGraphWithCoverageTest, onlySamplesWithCoverageAreStored)
+{
+    const uint32_t nb_of_nodes = 5;
+    KmerGraph kmergraph = create_kmergraph(nb_of_nodes);
+    const uint32_t nb_of_samples = 10;
+    KmerGraphWithCoverage kmergraph_with_coverage(&kmergraph, nb_of_samples);
+    std::map<Nodeindex_Strand_Sampleindex_Tuple, uint16_t> expected_coverage;
+    EXPECT_EQ(kmergraph_with_coverage.get_number_of_samples_with_coverage(), 0);
+
+    // zero coverages do not store anything
+    set_covg_helper(
+        kmergraph_with_coverage, expected_coverage, 1, 0, pandora::Strand::Forward, 2);
+    EXPECT_EQ(kmergraph_with_coverage.get_number_of_samples_with_coverage(), 0);
+
+    set_covg_helper(
+        kmergraph_with_coverage, expected_coverage, 1, 7, pandora::Strand::Forward, 2);
+    set_covg_helper(
+        kmergraph_with_coverage, expected_coverage, 3, 4, pandora::Strand::Reverse, 2);
+    increment_covg_helper(kmergraph_with_coverage, expected_coverage, 0, true, 8);
+    EXPECT_EQ(kmergraph_with_coverage.get_number_of_samples_with_coverage(), 2);
+    check_coverages(
+        kmergraph_with_coverage, expected_coverage, nb_of_nodes, nb_of_samples);
+
+    kmergraph_with_coverage.zeroCoverages();
+    EXPECT_EQ(kmergraph_with_coverage.get_number_of_samples_with_coverage(), 0);
+    expected_coverage.clear();
+    check_coverages(
+        kmergraph_with_coverage, expected_coverage, nb_of_nodes, nb_of_samples);
+}
+
 TEST(KmerGraphWithCoverageTest, incrementCoverage)
 {
     const uint32_t nb_of_nodes = 5;
@@ -672,6 +703,55 @@ TEST(KmerGraphWithCoverageTest, findMaxPath2Level_lin)
     EXPECT_EQ(mp_p, exp_p);
 }
 
+TEST(KmerGraphWithCoverageTest, findMaxPathFromVotes_sameAsLinOnVoteCoverages)
+{
+    KmerGraph kmergraph = setup_2level_kmergraph();
+    KmerGraphWithCoverage kmergraph_with_coverage(&kmergraph);
+
+    uint32_t sample_id = 0;
+    uint32_t max_num_kmers_to_average = 100;
+    kmergraph_with_coverage.set_num_reads(5);
+    kmergraph_with_coverage.kmer_prg->k = 3;
+
+    std::vector<uint32_t> node_votes(kmergraph.nodes.size(), 0);
+    node_votes[4] = 2;
+    node_votes[5] = 1;
+    node_votes[6] = 2;
+    node_votes[7] = 1;
+    node_votes[8] = 1;
+    for (uint32_t node_id = 0; node_id != node_votes.size(); ++node_id) {
+        kmergraph_with_coverage.set_forward_covg(
+            node_id, node_votes[node_id], sample_id);
+        kmergraph_with_coverage.set_reverse_covg(
+            node_id, node_votes[node_id], sample_id);
+    }
+
+    std::vector<KmerNodePtr> expected_path;
+    auto expected_prob = kmergraph_with_coverage.find_max_path(
+        expected_path, "lin", max_num_kmers_to_average, sample_id);
+
+    std::vector<KmerNodePtr> path;
+    auto prob = kmergraph_with_coverage.find_max_path_from_votes(
+        path, node_votes, 5, max_num_kmers_to_average);
+
+    EXPECT_ITERABLE_EQ(vector<KmerNodePtr>, expected_path, path);
+    EXPECT_EQ(expected_prob, prob);
+}
+
+TEST(KmerGraphWithCoverageTest, findMaxPathFromVotes_noVotes_returnsLowestProb)
+{
+    KmerGraph kmergraph = setup_2level_kmergraph();
+    KmerGraphWithCoverage kmergraph_with_coverage(&kmergraph);
+
+    std::vector<uint32_t> node_votes(kmergraph.nodes.size(), 0);
+    std::vector<KmerNodePtr> path;
+    auto prob
+        = kmergraph_with_coverage.find_max_path_from_votes(path, node_votes, 5, 100);
+
+    EXPECT_TRUE(path.empty());
+    EXPECT_EQ(std::numeric_limits<float>::lowest(), prob);
+}
+
 /*
 TEST(KmerGraphWithCoverageTest, find_max_paths_2Level) {
     KmerGraph kmergraph = setup_2level_kmergraph();
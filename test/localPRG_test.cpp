@@ -13,6 +13,7 @@
 #include "utils.h"
 #include "seq.h"
 #include "kmernode.h"
+#include "syncmer.h"
 #include <stdint.h>
 #include "test_helpers.h"
 
@@ -156,6 +157,33 @@ TEST(LocalPRGTest, string_along_path)
         "Error getting sequence along PRG path");
 }
 
+TEST(LocalPRGTest, string_along_path_releasedSeq)
+{
+    LocalPRG l3(3, "nested varsite", "A 5 G 7 C 8 T 7  6 G 5 T");
+    LocalPRG released_l3(3, "nested varsite", "A 5 G 7 C 8 T 7  6 G 5 T");
+    released_l3.release_seq();
+    EXPECT_EQ("", released_l3.seq);
+    EXPECT_EQ(l3.get_seq_length(), released_l3.get_seq_length());
+
+    deque<Interval> d
+        = { Interval(0, 1), Interval(4, 5), Interval(12, 13), Interval(16, 16),
+              Interval(23, 24) };
+    prg::Path p;
+    p.initialize(d);
+    EXPECT_EQ("AGTT", l3.string_along_path(p));
+    EXPECT_EQ(l3.string_along_path(p), released_l3.string_along_path(p));
+
+    d = { Interval(19, 20), Interval(23, 24) };
+    p.initialize(d);
+    EXPECT_EQ(l3.string_along_path(p), released_l3.string_along_path(p));
+
+    // the markers are not kept once the PRG string is released
+    d = { Interval(1, 3) };
+    p.initialize(d);
+    ASSERT_EXCEPTION(released_l3.string_along_path(p), FatalRuntimeError,
+        "Error getting sequence along PRG path");
+}
+
 TEST(LocalPRGTest, string_along_localpath)
 {
     LocalPRG l0(0, "empty", "");
@@ -519,6 +547,44 @@ TEST(LocalPRGTest, build_graph)
     EXPECT_EQ(lg3, l3.prg);
 }
 
+TEST(LocalPRGTest, build_graph_multiDigitSiteNumbers)
+{
+    LocalPRG l(0, "multi-digit sites",
+        "A 5 C 6 G 5 T 7 A 8 C 7 G 9 T 10 A 9 C 11 G 12 T 11 A");
+
+    LocalGraph lg;
+    lg.add_node(0, "A", Interval(0, 1));
+    lg.add_node(1, "C", Interval(4, 5));
+    lg.add_node(2, "G", Interval(8, 9));
+    lg.add_node(3, "T", Interval(12, 13));
+    lg.add_node(4, "A", Interval(16, 17));
+    lg.add_node(5, "C", Interval(20, 21));
+    lg.add_node(6, "G", Interval(24, 25));
+    lg.add_node(7, "T", Interval(28, 29));
+    lg.add_node(8, "A", Interval(33, 34));
+    lg.add_node(9, "C", Interval(37, 38));
+    lg.add_node(10, "G", Interval(42, 43));
+    lg.add_node(11, "T", Interval(47, 48));
+    lg.add_node(12, "A", Interval(52, 53));
+    lg.add_edge(0, 1);
+    lg.add_edge(0, 2);
+    lg.add_edge(1, 3);
+    lg.add_edge(2, 3);
+    lg.add_edge(3, 4);
+    lg.add_edge(3, 5);
+    lg.add_edge(4, 6);
+    lg.add_edge(5, 6);
+    lg.add_edge(6, 7);
+    lg.add_edge(6, 8);
+    lg.add_edge(7, 9);
+    lg.add_edge(8, 9);
+    lg.add_edge(9, 10);
+    lg.add_edge(9, 11);
+    lg.add_edge(10, 12);
+    lg.add_edge(11, 12);
+    EXPECT_EQ(lg, l.prg);
+}
+
 TEST(LocalPRGTest, shift)
 {
     LocalPRG l1(1, "simple", "AGCT");
@@ -899,6 +965,63 @@ TEST(LocalPRGTest, minimizer_sketch_SameAsSeqw15)
     }
 }
 
+TEST(LocalPRGTest, syncmer_sketch_SameAsSeq)
+{
+    std::string st
+        = "ATGGCAATCCGAATCTTCGCGATACTTTTCTCCATTTTTTCTCTTGCCACTTTCGCGCATGCGCAAGAAGGCACGC"
+          "TAGAACGTTCTGACTGGAGGAAGTTTTTCAGCGAATTTCAAGCCAAAGGCACGATAGTTGTGGCAGACGAACGCCA"
+          "AGCGGATCGTGCCATGTTGGTTTTTGATCCTGTGCGATCGAAGAAACGCTACTCGCCTGCATCGACATTCAAGATA";
+
+    auto index = std::make_shared<Index>();
+    LocalPRG l(0, "prg", st);
+    l.syncmer_sketch(index, 15, 11);
+
+    Seq s = Seq(0, "read", st, 1, 15, 11);
+
+    EXPECT_EQ(l.kmer_prg.nodes.size(), s.sketch.size() + 2);
+
+    std::set<Minimizer, MiniPos> sketch(s.sketch.begin(), s.sketch.end());
+    auto lit = l.kmer_prg.sorted_nodes.begin();
+    lit++;
+
+    for (auto sit = sketch.begin(); sit != sketch.end(); ++sit) {
+        EXPECT_EQ((*sit).pos_of_kmer_in_read, (*lit)->path[0]);
+        EXPECT_EQ((*sit).canonical_kmer_hash, (*lit)->khash);
+        ++lit;
+    }
+}
+
+TEST(LocalPRGTest, syncmer_sketch_nestedBubbles_allKmersAreSyncmers)
+{
+    LocalPRG l(4, "much more complex", "TC 5 ACTC 7 TAGTCA 8 TTGTGA 7  6 AACTAG 5 AG");
+    auto index = std::make_shared<Index>();
+    KmerHash hash;
+    const uint32_t k = 3, s = 2;
+
+    l.syncmer_sketch(index, k, s);
+
+    EXPECT_GT(l.kmer_prg.nodes.size(), (uint)2);
+    uint32_t number_of_records = 0;
+    for (const auto& minhash_it : index->minhash) {
+        number_of_records += minhash_it.second->size();
+    }
+    EXPECT_EQ(number_of_records, l.kmer_prg.nodes.size() - 2);
+
+    // the start and end nodes are null, every other node is a syncmer or the last k-mer
+    // of a path of the PRG without syncmers, which follows the start node
+    for (uint32_t i = 1; i + 1 < l.kmer_prg.nodes.size(); ++i) {
+        const auto& kmer_node = l.kmer_prg.nodes[i];
+        const std::string kmer = l.string_along_path(kmer_node->path);
+        const auto kh = hash.kmerhash(kmer, k);
+        EXPECT_EQ(kmer_node->khash, std::min(kh.first, kh.second));
+        const bool closes_path_without_syncmer
+            = kmer_node->find_node_ptr_in_in_nodes(l.kmer_prg.nodes[0])
+            != kmer_node->in_nodes.end();
+        EXPECT_TRUE(is_open_syncmer(kmer, s, kh.first <= kh.second, hash)
+            or closes_path_without_syncmer);
+    }
+}
+
 TEST(LocalPRGTest, localnode_path_from_kmernode_path)
 {
     LocalPRG l3(3, "nested varsite", "A 5 G 7 C 8 T 7  6 G 5 T");
@@ -1286,6 +1409,101 @@ TEST(LocalPRGTest, build_vcf)
     vcf.sort_records();
 }
 
+TEST(LocalPRGTest, get_vcf_sites)
+{
+    LocalPRG l3(3, "nested varsite", "A 5 G 7 C 8 T 7  6 G 5 T");
+
+    // sites are given as they are closed, so the nested site comes first
+    const std::vector<VCFSite> expected { { 2, "C", "T", "GRAPHTYPE=NESTED" },
+        { 1, "GC", "G", "GRAPHTYPE=NESTED" } };
+    EXPECT_TRUE(expected == l3.get_vcf_sites(l3.prg.top_path()));
+
+    vector<LocalNodePtr> single_node_path = { l3.prg.nodes[0] };
+    EXPECT_TRUE(l3.get_vcf_sites(single_node_path).empty());
+}
+
+TEST(LocalPRGTest, saveAndLoadVcfSites)
+{
+    LocalPRG l3(3, "nested varsite", "A 5 G 7 C 8 T 7  6 G 5 T");
+    LocalPRG loaded_l3(3, "nested varsite", "A 5 G 7 C 8 T 7  6 G 5 T");
+    const fs::path filepath { "nested_varsite_test.vcf_sites" };
+    l3.save_vcf_sites(filepath, l3.prg.top_path());
+    loaded_l3.vcf_sites_file = filepath;
+
+    vector<LocalNodePtr> other_path = { l3.prg.nodes[0], l3.prg.nodes[1],
+        l3.prg.nodes[3], l3.prg.nodes[4], l3.prg.nodes[6] };
+    vector<LocalNodePtr> loaded_other_path = { loaded_l3.prg.nodes[0],
+        loaded_l3.prg.nodes[1], loaded_l3.prg.nodes[3], loaded_l3.prg.nodes[4],
+        loaded_l3.prg.nodes[6] };
+    for (const auto& paths : { make_pair(l3.prg.top_path(), loaded_l3.prg.top_path()),
+             make_pair(other_path, loaded_other_path) }) {
+        VCF vcf = create_VCF_with_default_parameters();
+        l3.build_vcf_from_reference_path(vcf, paths.first);
+        VCF loaded_vcf = create_VCF_with_default_parameters();
+        loaded_l3.build_vcf_from_reference_path(loaded_vcf, paths.second);
+        ASSERT_EQ(vcf.get_VCF_size(), loaded_vcf.get_VCF_size());
+        for (uint32_t i = 0; i != vcf.get_VCF_size(); ++i) {
+            EXPECT_EQ(*vcf.get_records()[i], *loaded_vcf.get_records()[i]);
+        }
+    }
+    fs::remove(filepath);
+}
+
+TEST(LocalPRGTest, loadVcfSites_savedSitesAreReusedForTheSamePathOnly)
+{
+    LocalPRG l3(3, "nested varsite", "A 5 G 7 C 8 T 7  6 G 5 T");
+    const fs::path filepath { "reused_test.vcf_sites" };
+    {
+        fs::ofstream handle(filepath);
+        handle << "0 1 2 4 6\n1\tGC\tGA\tGRAPHTYPE=NESTED\n";
+    }
+    l3.vcf_sites_file = filepath;
+
+    VCF vcf = create_VCF_with_default_parameters();
+    l3.build_vcf_from_reference_path(vcf, l3.prg.top_path());
+    ASSERT_EQ((size_t)1, vcf.get_VCF_size());
+    EXPECT_EQ("GA", vcf.get_records()[0]->get_alts()[0]);
+
+    vcf = create_VCF_with_default_parameters();
+    vector<LocalNodePtr> other_path = { l3.prg.nodes[0], l3.prg.nodes[1],
+        l3.prg.nodes[3], l3.prg.nodes[4], l3.prg.nodes[6] };
+    l3.build_vcf_from_reference_path(vcf, other_path);
+    EXPECT_EQ((size_t)2, vcf.get_VCF_size());
+    fs::remove(filepath);
+}
+
+TEST(LocalPRGTest, loadVcfSites_sitesOfAnotherPathAreNotRead)
+{
+    LocalPRG l3(3, "nested varsite", "A 5 G 7 C 8 T 7  6 G 5 T");
+    const fs::path filepath { "other_path_test.vcf_sites" };
+    {
+        fs::ofstream handle(filepath);
+        handle << "0 1 3 4 6\nnot a site\n";
+    }
+    l3.vcf_sites_file = filepath;
+
+    VCF vcf = create_VCF_with_default_parameters();
+    l3.build_vcf_from_reference_path(vcf, l3.prg.top_path());
+    EXPECT_EQ((size_t)2, vcf.get_VCF_size());
+    fs::remove(filepath);
+}
+
+TEST(LocalPRGTest, loadVcfSites_inconsistentSite___expects_FatalRuntimeError)
+{
+    LocalPRG l3(3, "nested varsite", "A 5 G 7 C 8 T 7  6 G 5 T");
+    const fs::path filepath { "inconsistent_site_test.vcf_sites" };
+    {
+        fs::ofstream handle(filepath);
+        handle << "0 1 2 4 6\nnot a site\n";
+    }
+    l3.vcf_sites_file = filepath;
+
+    VCF vcf = create_VCF_with_default_parameters();
+    ASSERT_EXCEPTION(l3.build_vcf_from_reference_path(vcf, l3.prg.top_path()),
+        FatalRuntimeError, "should have a position, a ref, an alt and a graph type");
+    fs::remove(filepath);
+}
+
 TEST(LocalPRGTest, build_vcf_real)
 {
     LocalPRG l1(1, "GC00000008_13",
@@ -2097,6 +2315,79 @@ TEST(LocalPRGTest, add_sample_covgs_to_vcf)
         vcf.get_records()[1]->sampleIndex_to_sampleInfo[0].get_sum_reverse_coverage(1));
 }
 
+TEST(LocalPRGTest, add_sample_covgs_to_vcf_records_onlyGivenRecordsAreUpdated)
+{
+    auto index = std::make_shared<Index>();
+    LocalPRG l3(3, "nested varsite", "A 5 G 7 C 8 T 7  6 G 5 TAT");
+    l3.minimizer_sketch(index, 1, 3);
+    vector<LocalNodePtr> lmp3 = { l3.prg.nodes[0], l3.prg.nodes[1], l3.prg.nodes[3],
+        l3.prg.nodes[4], l3.prg.nodes[6] };
+    VCF vcf_without_covgs = create_VCF_with_default_parameters(0);
+    VCF vcf_with_all_covgs = create_VCF_with_default_parameters(0);
+    VCF vcf_with_some_covgs = create_VCF_with_default_parameters(0);
+    for (auto* vcf :
+        { &vcf_without_covgs, &vcf_with_all_covgs, &vcf_with_some_covgs }) {
+        l3.build_vcf_from_reference_path(*vcf, l3.prg.top_path());
+        vcf->sort_records();
+        l3.add_new_records_and_genotype_to_vcf_using_max_likelihood_path_of_the_sample(
+            *vcf, l3.prg.top_path(), lmp3, "sample");
+        vcf->sort_records();
+    }
+
+    KmerGraphWithCoverage kg(&l3.kmer_prg);
+    kg.set_forward_covg(1, 1, 0);
+    kg.set_forward_covg(2, 6, 0);
+    kg.set_reverse_covg(2, 8, 0);
+    kg.set_forward_covg(5, 5, 0);
+    kg.set_reverse_covg(5, 5, 0);
+
+    l3.add_sample_covgs_to_vcf(vcf_with_all_covgs, kg, l3.prg.top_path(), "sample", 0);
+    const auto ref_kmer_path
+        = l3.kmernode_path_from_localnode_path(l3.prg.top_path());
+    l3.add_sample_covgs_to_vcf_records({ vcf_with_some_covgs.get_records()[1].get() },
+        kg, l3.prg.top_path(), ref_kmer_path, 0, 0);
+
+    const auto& updated_info
+        = vcf_with_some_covgs.get_records()[1]->sampleIndex_to_sampleInfo[0];
+    const auto& expected_updated_info
+        = vcf_with_all_covgs.get_records()[1]->sampleIndex_to_sampleInfo[0];
+    EXPECT_EQ(expected_updated_info.get_allele_to_forward_coverages(),
+        updated_info.get_allele_to_forward_coverages());
+    EXPECT_EQ(expected_updated_info.get_allele_to_reverse_coverages(),
+        updated_info.get_allele_to_reverse_coverages());
+
+    const auto& not_updated_info
+        = vcf_with_some_covgs.get_records()[0]->sampleIndex_to_sampleInfo[0];
+    const auto& expected_not_updated_info
+        = vcf_without_covgs.get_records()[0]->sampleIndex_to_sampleInfo[0];
+    EXPECT_EQ(expected_not_updated_info.get_allele_to_forward_coverages(),
+        not_updated_info.get_allele_to_forward_coverages());
+    EXPECT_EQ(expected_not_updated_info.get_allele_to_reverse_coverages(),
+        not_updated_info.get_allele_to_reverse_coverages());
+}
+
+TEST(LocalPRGTest, build_sample_vcf_sameRecordsAsAddVariantsToVcf)
+{
+    auto index = std::make_shared<Index>();
+    auto l3 { std::make_shared<LocalPRG>(3, "three", "A 5 G 7 C 8 T 7  6 G 5 TAT") };
+    l3->minimizer_sketch(index, 1, 3);
+    vector<LocalNodePtr> lmp3 = { l3->prg.nodes[0], l3->prg.nodes[1], l3->prg.nodes[3],
+        l3->prg.nodes[4], l3->prg.nodes[6] };
+
+    shared_ptr<pangenome::Node> pn3(make_shared<pangenome::Node>(l3));
+    pn3->kmer_prg_with_coverage.set_forward_covg(2, 6, 0);
+    pn3->kmer_prg_with_coverage.set_reverse_covg(2, 8, 0);
+    pn3->kmer_prg_with_coverage.set_forward_covg(5, 5, 0);
+
+    VCF sample_vcf = create_VCF_with_default_parameters(0);
+    l3->build_sample_vcf(sample_vcf, pn3, "", {}, lmp3);
+    VCF master_vcf = create_VCF_with_default_parameters(0);
+    l3->add_variants_to_vcf(master_vcf, pn3, "", {}, lmp3);
+
+    EXPECT_FALSE(sample_vcf.get_records().empty());
+    EXPECT_EQ(master_vcf, sample_vcf);
+}
+
 TEST(LocalPRGTest, add_consensus_path_to_fastaq_bin)
 {
     auto index = std::make_shared<Index>();
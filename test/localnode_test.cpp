@@ -12,7 +12,7 @@ TEST(LocalNodeTest, create)
     LocalNode ln("ACGTA", Interval(0, 5), 0);
 
     uint32_t j = 1;
-    EXPECT_EQ("ACGTA", ln.seq);
+    EXPECT_EQ("ACGTA", ln.seq.to_string());
     EXPECT_EQ(Interval(0, 5), ln.pos);
     j = 0;
     EXPECT_EQ(j, ln.id);
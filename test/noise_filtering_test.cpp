@@ -1833,6 +1833,172 @@ TEST(NoiseFilteringTest, clean_pangraph_with_debruijn_graph)
     // EXPECT_EQ(pg_exp, *pg);
 }
 
+TEST(NoiseFilteringSplitPangraphIntoComponents, TwoComponents_ReadsAndNodesSplit)
+{
+    set<MinimizerHitPtr, pComp> dummy_cluster;
+    auto pangraph = std::make_shared<pangenome::Graph>(pangenome::Graph());
+
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+    for (uint32_t i = 0; i < 6; ++i) {
+        prgs.push_back(std::make_shared<LocalPRG>(i, std::to_string(i), ""));
+    }
+
+    // read 0: 0->1->2, read 1: 4->5, read 2: 2->3
+    pangraph->add_hits_between_PRG_and_read(prgs[0], 0, dummy_cluster);
+    pangraph->add_hits_between_PRG_and_read(prgs[1], 0, dummy_cluster);
+    pangraph->add_hits_between_PRG_and_read(prgs[2], 0, dummy_cluster);
+    pangraph->add_hits_between_PRG_and_read(prgs[4], 1, dummy_cluster);
+    pangraph->add_hits_between_PRG_and_read(prgs[5], 1, dummy_cluster);
+    pangraph->add_hits_between_PRG_and_read(prgs[2], 2, dummy_cluster);
+    pangraph->add_hits_between_PRG_and_read(prgs[3], 2, dummy_cluster);
+
+    const auto components = split_pangraph_into_components(pangraph);
+
+    ASSERT_EQ(components.graphs.size(), (uint)2);
+    std::set<uint32_t> read_ids, node_ids;
+    for (const auto& read_entry : components.graphs[0]->reads)
+        read_ids.insert(read_entry.first);
+    for (const auto& node_entry : components.graphs[0]->nodes)
+        node_ids.insert(node_entry.first);
+    EXPECT_EQ(read_ids, std::set<uint32_t>({ 0, 2 }));
+    EXPECT_EQ(node_ids, std::set<uint32_t>({ 0, 1, 2, 3 }));
+
+    read_ids.clear();
+    node_ids.clear();
+    for (const auto& read_entry : components.graphs[1]->reads)
+        read_ids.insert(read_entry.first);
+    for (const auto& node_entry : components.graphs[1]->nodes)
+        node_ids.insert(node_entry.first);
+    EXPECT_EQ(read_ids, std::set<uint32_t>({ 1 }));
+    EXPECT_EQ(node_ids, std::set<uint32_t>({ 4, 5 }));
+
+    EXPECT_EQ(components.node_id_to_component.at(3), (uint)0);
+    EXPECT_EQ(components.node_id_to_component.at(4), (uint)1);
+    EXPECT_EQ(components.read_id_to_component.at(2), (uint)0);
+    EXPECT_EQ(components.read_id_to_component.at(1), (uint)1);
+}
+
+TEST(NoiseFilteringMergePangraphComponents, CreatedAndRemovedNodes_MergedIntoPangraph)
+{
+    set<MinimizerHitPtr, pComp> dummy_cluster;
+    auto pangraph = std::make_shared<pangenome::Graph>(pangenome::Graph());
+
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+    for (uint32_t i = 0; i < 6; ++i) {
+        prgs.push_back(std::make_shared<LocalPRG>(i, std::to_string(i), ""));
+    }
+
+    // read 0: 0->1->2, read 1: 4->5, read 2: 2->3
+    pangraph->add_hits_between_PRG_and_read(prgs[0], 0, dummy_cluster);
+    pangraph->add_hits_between_PRG_and_read(prgs[1], 0, dummy_cluster);
+    pangraph->add_hits_between_PRG_and_read(prgs[2], 0, dummy_cluster);
+    pangraph->add_hits_between_PRG_and_read(prgs[4], 1, dummy_cluster);
+    pangraph->add_hits_between_PRG_and_read(prgs[5], 1, dummy_cluster);
+    pangraph->add_hits_between_PRG_and_read(prgs[2], 2, dummy_cluster);
+    pangraph->add_hits_between_PRG_and_read(prgs[3], 2, dummy_cluster);
+
+    const auto components = split_pangraph_into_components(pangraph);
+    ASSERT_EQ(components.graphs.size(), (uint)2);
+
+    // node 1 is replaced by a new node in read 0, which gets id 4 in its component
+    std::unordered_set<pangenome::ReadPtr> reads_along_tig
+        = { components.graphs[0]->reads.at(0) };
+    std::vector<uint_least32_t> tig_node_ids = { 0, 1, 2 };
+    const std::vector<bool> tig_node_orients = { 0, 0, 0 };
+    components.graphs[0]->split_node_by_reads(
+        reads_along_tig, tig_node_ids, tig_node_orients, 1);
+    EXPECT_EQ(tig_node_ids, std::vector<uint_least32_t>({ 0, 4, 2 }));
+    // read 1 and nodes 4 and 5 are removed from the other component
+    components.graphs[1]->remove_read(1);
+
+    merge_pangraph_components(pangraph, components);
+
+    std::set<uint32_t> read_ids, node_ids;
+    for (const auto& read_entry : pangraph->reads)
+        read_ids.insert(read_entry.first);
+    for (const auto& node_entry : pangraph->nodes)
+        node_ids.insert(node_entry.first);
+    EXPECT_EQ(read_ids, std::set<uint32_t>({ 0, 2 }));
+    EXPECT_EQ(node_ids, std::set<uint32_t>({ 0, 2, 3, 6 }));
+
+    const auto& created_node = pangraph->nodes.at(6);
+    EXPECT_EQ(created_node->prg_id, (uint)1);
+    EXPECT_EQ(created_node->reads.count(pangraph->reads.at(0)), (uint)1);
+    std::vector<uint32_t> read_node_ids;
+    for (const auto& node : pangraph->reads.at(0)->get_nodes())
+        read_node_ids.push_back(node.lock()->node_id);
+    EXPECT_EQ(read_node_ids, std::vector<uint32_t>({ 0, 6, 2 }));
+}
+
+namespace {
+// a pangraph with one component per offset, each with the reads of
+// NoiseFilteringTest.clean_pangraph_with_debruijn_graph on PRGs offset to offset + 7
+std::shared_ptr<pangenome::Graph> make_pangraph_with_components(
+    const std::vector<std::shared_ptr<LocalPRG>>& prgs,
+    const std::vector<uint32_t>& offsets)
+{
+    set<MinimizerHitPtr, pComp> dummy_cluster;
+    auto pangraph = std::make_shared<pangenome::Graph>(pangenome::Graph());
+    const std::vector<std::vector<uint32_t>> reads_prgs { { 0, 1, 2, 3, 4, 5 },
+        { 0, 1, 2, 3, 4, 5 }, { 1, 2, 3, 7 }, { 0, 5, 3, 4 },
+        { 0, 1, 2, 6, 3, 4, 5 }, { 0, 1, 2, 3, 4, 5 } };
+    uint32_t read_id = 0;
+    for (const auto offset : offsets) {
+        for (const auto& read_prgs : reads_prgs) {
+            for (const auto prg : read_prgs) {
+                pangraph->add_hits_between_PRG_and_read(
+                    prgs[offset + prg], read_id, dummy_cluster);
+            }
+            ++read_id;
+        }
+    }
+    return pangraph;
+}
+
+// the PRGs and coverages of the nodes along each read, which do not depend on the ids
+// of the nodes created when detangling
+std::map<uint32_t, std::vector<std::pair<uint32_t, uint32_t>>> get_reads_prgs_and_covgs(
+    const pangenome::Graph& pangraph)
+{
+    std::map<uint32_t, std::vector<std::pair<uint32_t, uint32_t>>> reads_prgs_and_covgs;
+    for (const auto& read_entry : pangraph.reads) {
+        auto& prgs_and_covgs = reads_prgs_and_covgs[read_entry.first];
+        for (const auto& node : read_entry.second->get_nodes()) {
+            prgs_and_covgs.emplace_back(node.lock()->prg_id, node.lock()->covg);
+        }
+    }
+    return reads_prgs_and_covgs;
+}
+}
+
+TEST(NoiseFilteringTest, clean_pangraph_with_debruijn_graph_byComponentSameAsSerial)
+{
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+    for (uint32_t i = 0; i < 24; ++i) {
+        prgs.push_back(std::make_shared<LocalPRG>(i, std::to_string(i), ""));
+    }
+    const std::vector<uint32_t> offsets { 0, 8, 16 };
+    auto serial_pangraph = make_pangraph_with_components(prgs, offsets);
+    auto component_pangraph = make_pangraph_with_components(prgs, offsets);
+    ASSERT_EQ(split_pangraph_into_components(component_pangraph).graphs.size(),
+        offsets.size());
+
+    clean_pangraph_with_debruijn_graph(serial_pangraph, 3, 1);
+    clean_pangraph_with_debruijn_graph(component_pangraph, 3, 1, false, true, 2);
+
+    // the noisy nodes and the incorrect read of each component are removed
+    EXPECT_EQ(serial_pangraph->nodes.size(), (uint)18);
+    EXPECT_EQ(serial_pangraph->reads.count(3), (uint)0);
+    EXPECT_EQ(get_reads_prgs_and_covgs(*serial_pangraph),
+        get_reads_prgs_and_covgs(*component_pangraph));
+    std::multiset<uint32_t> serial_node_prgs, component_node_prgs;
+    for (const auto& node_entry : serial_pangraph->nodes)
+        serial_node_prgs.insert(node_entry.second->prg_id);
+    for (const auto& node_entry : component_pangraph->nodes)
+        component_node_prgs.insert(node_entry.second->prg_id);
+    EXPECT_EQ(serial_node_prgs, component_node_prgs);
+}
+
 TEST(NoiseFilteringTest, write_pangraph_gfa)
 {
     set<MinimizerHitPtr, pComp> dummy_cluster;
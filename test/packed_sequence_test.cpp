@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "packed_sequence.h"
+#include "test_helpers.h"
+#include <sstream>
+
+using namespace std;
+
+TEST(PackedSequenceTest, create_empty)
+{
+    PackedSequence sequence;
+    EXPECT_TRUE(sequence.empty());
+    EXPECT_EQ((uint32_t)0, sequence.length());
+    EXPECT_EQ("", sequence.to_string());
+}
+
+TEST(PackedSequenceTest, to_string_ACGTOnly)
+{
+    const string s = "ACGTTGCAAACCGGTTACGTACGTACGTACGTACGTAC";
+    PackedSequence sequence(s);
+    EXPECT_EQ(s.size(), sequence.length());
+    EXPECT_EQ(s, sequence.to_string());
+}
+
+TEST(PackedSequenceTest, to_string_keepsNonACGTCharacters)
+{
+    const string s = "ACNGTacgtRYA-CG";
+    PackedSequence sequence(s);
+    EXPECT_EQ(s, sequence.to_string());
+    EXPECT_EQ('N', sequence.at(2));
+    EXPECT_EQ('c', sequence.at(6));
+    EXPECT_EQ('G', sequence.at(3));
+}
+
+TEST(PackedSequenceTest, substr)
+{
+    const string s = "ACGTTGCAAACCGGTTACGTNCGTACGTACGTACGTAC";
+    PackedSequence sequence(s);
+    EXPECT_EQ(s.substr(0, 3), sequence.substr(0, 3));
+    EXPECT_EQ(s.substr(18, 5), sequence.substr(18, 5));
+    EXPECT_EQ(s.substr(30), sequence.substr(30));
+    EXPECT_EQ("", sequence.substr(s.size(), 2));
+    ASSERT_EXCEPTION(sequence.substr(s.size() + 1, 2), FatalRuntimeError,
+        "Error decoding packed sequence");
+}
+
+TEST(PackedSequenceTest, append_to)
+{
+    PackedSequence sequence("GCNTA");
+    string s = "AA";
+    sequence.append_to(s);
+    EXPECT_EQ("AAGCNTA", s);
+    sequence.append_to(s, 2, 2);
+    EXPECT_EQ("AAGCNTANT", s);
+}
+
+TEST(PackedSequenceTest, at_outOfRange)
+{
+    PackedSequence sequence("ACGT");
+    ASSERT_EXCEPTION(
+        sequence.at(4), FatalRuntimeError, "Error getting base 4 of a packed sequence");
+}
+
+TEST(PackedSequenceTest, equals)
+{
+    PackedSequence sequence1("ACGTN");
+    PackedSequence sequence2("ACGTN");
+    PackedSequence sequence3("ACGTA");
+    PackedSequence sequence4("ACGT");
+    EXPECT_EQ(sequence1, sequence2);
+    EXPECT_NE(sequence1, sequence3);
+    EXPECT_NE(sequence1, sequence4);
+}
+
+TEST(PackedSequenceTest, write)
+{
+    PackedSequence sequence("ACGTn");
+    stringstream out;
+    out << sequence;
+    EXPECT_EQ("ACGTn", out.str());
+}
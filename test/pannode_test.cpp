@@ -1645,4 +1645,77 @@ TEST(ExtractReadsTest, get_read_overlap_coordinates_no_duplicates)
     const auto overlaps { pan_node->get_read_overlap_coordinates(local_path) };
 
     EXPECT_ITERABLE_EQ(std::set<ReadCoordinate>, expected_overlaps, overlaps);
-}
\ No newline at end of file
+}
+TEST(ExtractReadsTest, get_read_overlap_coordinates_withReadHitTable)
+{
+    uint32_t knode_id = 0;
+    bool orientation(true);
+    const uint32_t prg_id = 3;
+    auto local_prg_ptr { std::make_shared<LocalPRG>(prg_id, "three", "") };
+    PanNodePtr pan_node = make_shared<pangenome::Node>(local_prg_ptr);
+    const auto make_path { [](const std::vector<Interval>& intervals) {
+        prg::Path path;
+        path.initialize(intervals);
+        return path;
+    } };
+
+    const prg::Path first_path { make_path(
+        { Interval(4, 5), Interval(8, 9), Interval(16, 17) }) };
+    const prg::Path second_path { make_path({ Interval(8, 9), Interval(16, 17),
+        Interval(27, 28) }) };
+    const prg::Path third_path { make_path({ Interval(27, 30) }) };
+    const MiniRecord first_record(prg_id, first_path, knode_id, orientation);
+    const MiniRecord second_record(prg_id, second_path, knode_id, orientation);
+    const MiniRecord third_record(prg_id, third_path, knode_id, orientation);
+
+    // read 0 hits the three records, read 1 only the last two
+    PanReadPtr read_0 = make_shared<pangenome::Read>(0);
+    set<MinimizerHitPtr, pComp> hits;
+    hits.insert(make_shared<MinimizerHit>(
+        0, Minimizer(0, 3, 6, orientation), first_record));
+    hits.insert(make_shared<MinimizerHit>(
+        0, Minimizer(0, 4, 7, orientation), second_record));
+    hits.insert(make_shared<MinimizerHit>(
+        0, Minimizer(0, 6, 9, orientation), third_record));
+    read_0->add_hits(pan_node, hits);
+    pan_node->reads.insert(read_0);
+    hits.clear();
+
+    PanReadPtr read_1 = make_shared<pangenome::Read>(1);
+    hits.insert(make_shared<MinimizerHit>(
+        1, Minimizer(0, 10, 13, orientation), second_record));
+    hits.insert(make_shared<MinimizerHit>(
+        1, Minimizer(0, 12, 15, orientation), third_record));
+    read_1->add_hits(pan_node, hits);
+    pan_node->reads.insert(read_1);
+    pan_node->reads.insert(read_1);
+    hits.clear();
+
+    const auto read_hit_table { pan_node->build_read_hit_table() };
+    EXPECT_EQ(read_hit_table.size(), 5u);
+    EXPECT_TRUE(std::is_sorted(read_hit_table.cbegin(), read_hit_table.cend(),
+        [](const pangenome::Node::ReadHit& lhs, const pangenome::Node::ReadHit& rhs) {
+            return lhs.prg_start < rhs.prg_start;
+        }));
+
+    const prg::Path whole_path { make_path({ Interval(4, 5), Interval(8, 9),
+        Interval(16, 17), Interval(27, 30) }) };
+    const std::set<ReadCoordinate> expected_whole_path_overlaps { { 0, 3, 9, 1 },
+        { 1, 10, 15, 1 } };
+    EXPECT_ITERABLE_EQ(std::set<ReadCoordinate>, expected_whole_path_overlaps,
+        pan_node->get_read_overlap_coordinates(whole_path, read_hit_table));
+    EXPECT_ITERABLE_EQ(std::set<ReadCoordinate>, expected_whole_path_overlaps,
+        pan_node->get_read_overlap_coordinates(whole_path));
+
+    const prg::Path end_of_path { make_path({ Interval(8, 9), Interval(16, 17),
+        Interval(27, 30) }) };
+    const std::set<ReadCoordinate> expected_end_of_path_overlaps { { 0, 4, 9, 1 },
+        { 1, 10, 15, 1 } };
+    EXPECT_ITERABLE_EQ(std::set<ReadCoordinate>, expected_end_of_path_overlaps,
+        pan_node->get_read_overlap_coordinates(end_of_path, read_hit_table));
+
+    const prg::Path start_of_path { make_path({ Interval(4, 5), Interval(8, 9),
+        Interval(16, 17) }) };
+    EXPECT_TRUE(
+        pan_node->get_read_overlap_coordinates(start_of_path, read_hit_table).empty());
+}
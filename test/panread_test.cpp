@@ -218,6 +218,43 @@ TEST(PangenomeReadTest, find_position)
     EXPECT_EQ(p.second, truth.second);
 }
 
+TEST(PangenomeReadTest, find_position_afterReplacingAndRemovingNodes)
+{
+    std::set<MinimizerHitPtr, pComp> dummy_cluster;
+    pangenome::Graph pg;
+
+    auto l0 = std::make_shared<LocalPRG>(0, "0", "");
+    auto l1 = std::make_shared<LocalPRG>(1, "1", "");
+    auto l2 = std::make_shared<LocalPRG>(2, "2", "");
+    auto l3 = std::make_shared<LocalPRG>(3, "3", "");
+
+    // read 0: 0->1->2->3->1
+    pg.add_hits_between_PRG_and_read(l0, 0, dummy_cluster);
+    pg.add_hits_between_PRG_and_read(l1, 0, dummy_cluster);
+    pg.add_hits_between_PRG_and_read(l2, 0, dummy_cluster);
+    pg.add_hits_between_PRG_and_read(l3, 0, dummy_cluster);
+    pg.add_hits_between_PRG_and_read(l1, 0, dummy_cluster);
+
+    const std::vector<bool> b = { 0, 0 };
+    const auto not_found = std::make_pair(
+        std::numeric_limits<uint32_t>::max(), std::numeric_limits<uint32_t>::max());
+    EXPECT_EQ(pg.reads[0]->find_position({ 2, 3 }, b), std::make_pair(2u, 3u));
+
+    // read 0: 0->1->5->3->1
+    NodePtr n = std::make_shared<pangenome::Node>(l2, 5);
+    pg.nodes[5] = n;
+    pg.reads[0]->replace_node_with_iterator(pg.reads[0]->get_nodes().begin() + 2, n);
+    EXPECT_EQ(pg.reads[0]->find_position({ 2, 3 }, b), not_found);
+    EXPECT_EQ(pg.reads[0]->find_position({ 5, 3 }, b), std::make_pair(2u, 3u));
+
+    // read 0: 1->5->3->1
+    pg.reads[0]->remove_node_with_iterator(pg.reads[0]->get_nodes().begin());
+    EXPECT_EQ(pg.reads[0]->find_position({ 1, 5 }, b), std::make_pair(0u, 1u));
+    EXPECT_EQ(pg.reads[0]->find_position({ 5, 3 }, b), std::make_pair(1u, 2u));
+    EXPECT_EQ(pg.reads[0]->find_position({ 3, 1 }, b), std::make_pair(2u, 3u));
+    EXPECT_EQ(pg.reads[0]->find_position({ 0, 1 }, b), std::make_pair(0u, 0u));
+}
+
 TEST(PangenomeReadTest, remove_node)
 {
 
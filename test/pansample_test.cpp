@@ -2,6 +2,10 @@
 #include "pangenome/ns.cpp"
 #include "pangenome/pannode.h"
 #include "pangenome/pansample.h"
+#include "kmergraph.h"
+#include "kmernode.h"
+#include "test_macro.cpp"
+#include "test_helpers.h"
 #include <stdint.h>
 #include <iostream>
 
@@ -67,3 +71,52 @@ TEST(PangenomeSampleTest, less)
     EXPECT_EQ((ps1 < ps2), true);
     EXPECT_EQ((ps2 < ps1), false);
 }
+
+TEST(PangenomeSampleTest, samplePath_getNodeIds)
+{
+    const std::vector<uint32_t> node_ids { 0, 1, 5, 3, 200, 70000, 2, 4294967295, 7 };
+    std::vector<KmerNodePtr> kmer_path;
+    for (const auto node_id : node_ids) {
+        kmer_path.push_back(std::make_shared<KmerNode>(node_id, prg::Path()));
+    }
+
+    const SamplePath sample_path(kmer_path);
+
+    EXPECT_EQ(node_ids.size(), sample_path.size());
+    EXPECT_ITERABLE_EQ(std::vector<uint32_t>, node_ids, sample_path.get_node_ids());
+}
+
+TEST(PangenomeSampleTest, samplePath_empty)
+{
+    const SamplePath sample_path((std::vector<KmerNodePtr>()));
+
+    EXPECT_TRUE(sample_path.empty());
+    EXPECT_TRUE(sample_path.get_node_ids().empty());
+}
+
+TEST(PangenomeSampleTest, samplePath_getKmerPath)
+{
+    KmerGraph kmer_graph;
+    for (uint32_t i = 0; i < 5; ++i) {
+        prg::Path path;
+        path.initialize(Interval(i, i + 3));
+        kmer_graph.add_node(path);
+    }
+    const std::vector<KmerNodePtr> kmer_path { kmer_graph.nodes[0],
+        kmer_graph.nodes[2], kmer_graph.nodes[4] };
+
+    const SamplePath sample_path(kmer_path);
+
+    EXPECT_ITERABLE_EQ(std::vector<KmerNodePtr>, kmer_path,
+        sample_path.get_kmer_path(kmer_graph));
+}
+
+TEST(PangenomeSampleTest, samplePath_getKmerPath_nodeNotInGraph___expects_FatalRuntimeError)
+{
+    KmerGraph kmer_graph;
+    const SamplePath sample_path(
+        std::vector<KmerNodePtr> { std::make_shared<KmerNode>(3, prg::Path()) });
+
+    ASSERT_EXCEPTION(sample_path.get_kmer_path(kmer_graph), FatalRuntimeError,
+        "is not in the k-mer graph");
+}
@@ -355,3 +355,14 @@ TEST(PathTest, get_union)
     ASSERT_EXCEPTION(get_union(p1, p2), FatalRuntimeError,
         "Error when getting the union of two paths");
 }
+
+TEST(PathTest, hash_equal_paths_have_equal_hashes)
+{
+    prg::Path p, q, r;
+    p.initialize(std::vector<Interval> { Interval(0, 1), Interval(4, 6) });
+    q.initialize(std::vector<Interval> { Interval(0, 1), Interval(4, 6) });
+    r.initialize(std::vector<Interval> { Interval(0, 1), Interval(4, 7) });
+
+    EXPECT_EQ(std::hash<prg::Path>()(p), std::hash<prg::Path>()(q));
+    EXPECT_NE(std::hash<prg::Path>()(p), std::hash<prg::Path>()(r));
+}
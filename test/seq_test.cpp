@@ -2,8 +2,10 @@
 #include "seq.h"
 #include "minimizer.h"
 #include "interval.h"
+#include "utils.h"
 #include <stdint.h>
 #include <iostream>
+#include <set>
 
 using namespace std;
 
@@ -94,3 +96,35 @@ TEST(SeqTest, sketchIncludesEveryLetter)
         EXPECT_EQ((pos_inc.find(i) != pos_inc.end()), true);
     }
 }
+
+TEST(SeqTest, syncmerSketch_sameKmersOnBothStrands)
+{
+    const std::string st = "ATGGCAATCCGAATCTTCGCGATACTTTTCTCCATTTTTTCTCTTGCCACTTTCGCGCATGC"
+                           "GCAAGAAGGCACGCTAGAACGTTCTGACTGGAGGAAGTTTTTCAGCGAATTTCAAG";
+    Seq s1(0, "forward", st, 1, 15, 5);
+    Seq s2(0, "reverse", rev_complement(st), 1, 15, 5);
+
+    EXPECT_FALSE(s1.sketch.empty());
+    EXPECT_EQ(s1.sketch.size(), s2.sketch.size());
+    std::set<uint64_t> hashes1, hashes2;
+    for (const auto& minimizer : s1.sketch) {
+        hashes1.insert(minimizer.canonical_kmer_hash);
+    }
+    for (const auto& minimizer : s2.sketch) {
+        hashes2.insert(minimizer.canonical_kmer_hash);
+    }
+    EXPECT_EQ(hashes1, hashes2);
+}
+
+TEST(SeqTest, syncmerSketch_sparserThanAllKmers)
+{
+    const std::string st = "ATGGCAATCCGAATCTTCGCGATACTTTTCTCCATTTTTTCTCTTGCCACTTTCGCGCATGC"
+                           "GCAAGAAGGCACGCTAGAACGTTCTGACTGGAGGAAGTTTTTCAGCGAATTTCAAG";
+    Seq all_kmers(0, "0", st, 1, 15);
+    Seq syncmers(0, "0", st, 1, 15, 11);
+
+    EXPECT_LT(syncmers.sketch.size(), all_kmers.sketch.size());
+    for (const auto& minimizer : syncmers.sketch) {
+        EXPECT_TRUE(all_kmers.sketch.find(minimizer) != all_kmers.sketch.end());
+    }
+}
@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+#include "syncmer.h"
+#include "inthash.h"
+#include "utils.h"
+#include <stdint.h>
+
+TEST(SyncmerTest, isOpenSyncmer_firstSmerSmallest_True)
+{
+    const uint64_t smer_hashes[] = { 1, 5, 3, 4 };
+    EXPECT_TRUE(is_open_syncmer(smer_hashes, 4, true));
+}
+
+TEST(SyncmerTest, isOpenSyncmer_firstSmerNotSmallest_False)
+{
+    const uint64_t smer_hashes[] = { 3, 5, 1, 4 };
+    EXPECT_FALSE(is_open_syncmer(smer_hashes, 4, true));
+}
+
+TEST(SyncmerTest, isOpenSyncmer_tieWithFirstSmer_True)
+{
+    const uint64_t smer_hashes[] = { 2, 5, 2, 4 };
+    EXPECT_TRUE(is_open_syncmer(smer_hashes, 4, true));
+}
+
+TEST(SyncmerTest, isOpenSyncmer_reverseIsCanonical_lastSmerIsFirst)
+{
+    const uint64_t smer_hashes[] = { 4, 5, 3, 1 };
+    EXPECT_TRUE(is_open_syncmer(smer_hashes, 4, false));
+    EXPECT_FALSE(is_open_syncmer(smer_hashes, 4, true));
+}
+
+TEST(SyncmerTest, isOpenSyncmer_sameOnBothStrands)
+{
+    KmerHash hash;
+    const uint32_t k = 15, s = 5;
+    const std::string seq = "ATGGCAATCCGAATCTTCGCGATACTTTTCTCCATTTTTTCTCTTGCCACTTTC";
+    for (uint32_t i = 0; i + k <= seq.length(); ++i) {
+        const std::string kmer = seq.substr(i, k);
+        const std::string rc_kmer = rev_complement(kmer);
+        const auto kh = hash.kmerhash(kmer, k);
+        const auto rc_kh = hash.kmerhash(rc_kmer, k);
+        EXPECT_EQ(is_open_syncmer(kmer, s, kh.first <= kh.second, hash),
+            is_open_syncmer(rc_kmer, s, rc_kh.first <= rc_kh.second, hash));
+    }
+}
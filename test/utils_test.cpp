@@ -14,6 +14,8 @@
 #include <iostream>
 #include <algorithm>
 #include <vector>
+#include <map>
+#include <fstream>
 #include "fatal_error.h"
 #include "test_helpers.h"
 
@@ -144,6 +146,195 @@ TEST(UtilsTest, readPrgFile_with_offset)
     EXPECT_EQ(prgs[2]->id, (uint)8);
 }
 
+TEST(UtilsTest, readPrgFile_onlyLociToLoad)
+{
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+    read_prg_file(prgs, TEST_CASE_DIR + "prg0123.fa", 0, { "prg1", "prg3" });
+
+    // the PRGs not to load keep their ids, but are not built
+    EXPECT_EQ(prgs.size(), (uint)3);
+    EXPECT_EQ(prgs[0]->id, (uint)0);
+    EXPECT_EQ(prgs[0]->name, "prg1");
+    EXPECT_TRUE(prgs[1] == nullptr);
+    EXPECT_EQ(prgs[2]->id, (uint)2);
+    EXPECT_EQ(prgs[2]->name, "prg3");
+
+    const std::unordered_set<uint32_t> expected_ids { 0, 2 };
+    EXPECT_EQ(get_loaded_prg_ids(prgs), expected_ids);
+}
+
+TEST(UtilsTest, readPrgFile_noLociToLoadLoadsAll)
+{
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+    read_prg_file(prgs, TEST_CASE_DIR + "prg0123.fa", 0, {});
+
+    EXPECT_EQ(prgs.size(), (uint)3);
+    const std::unordered_set<uint32_t> expected_ids { 0, 1, 2 };
+    EXPECT_EQ(get_loaded_prg_ids(prgs), expected_ids);
+}
+
+TEST(UtilsTest, loadLociFile)
+{
+    const std::string loci_filepath { "loci_file_test.txt" };
+    {
+        std::ofstream loci_file(loci_filepath);
+        loci_file << "prg1\n\n  prg3 \nprg1\n";
+    }
+
+    const std::unordered_set<std::string> expected { "prg1", "prg3" };
+    EXPECT_EQ(load_loci_file(loci_filepath), expected);
+}
+
+TEST(UtilsTest, loadLociFile_emptyFile___expects_FatalRuntimeError)
+{
+    const std::string loci_filepath { "empty_loci_file_test.txt" };
+    {
+        std::ofstream loci_file(loci_filepath);
+    }
+
+    ASSERT_EXCEPTION(
+        load_loci_file(loci_filepath), FatalRuntimeError, "No loci given in loci file");
+}
+
+TEST(UtilsTest, prgSliceFromString)
+{
+    const auto range_slice = PrgSlice::from_string("2-5");
+    EXPECT_FALSE(range_slice.is_shard());
+    EXPECT_EQ(range_slice.get_range(10), std::make_pair((uint32_t)2, (uint32_t)5));
+    EXPECT_EQ(range_slice.get_range(4), std::make_pair((uint32_t)2, (uint32_t)4));
+
+    const auto shard_slice = PrgSlice::from_string("2/3");
+    EXPECT_TRUE(shard_slice.is_shard());
+    EXPECT_EQ(shard_slice.get_range(10), std::make_pair((uint32_t)3, (uint32_t)6));
+    EXPECT_EQ(PrgSlice::from_string("3/3").get_range(10),
+        std::make_pair((uint32_t)6, (uint32_t)10));
+
+    ASSERT_EXCEPTION(PrgSlice::from_string("2"), FatalRuntimeError,
+        "should be given as START-END or I/N");
+    ASSERT_EXCEPTION(PrgSlice::from_string("a-3"), FatalRuntimeError,
+        "should be given as START-END or I/N");
+    ASSERT_EXCEPTION(
+        PrgSlice::from_string("3-3"), FatalRuntimeError, "START must be less than END");
+    ASSERT_EXCEPTION(
+        PrgSlice::from_string("0/3"), FatalRuntimeError, "should have 1 <= I <= N");
+    ASSERT_EXCEPTION(
+        PrgSlice::from_string("4/3"), FatalRuntimeError, "should have 1 <= I <= N");
+}
+
+TEST(UtilsTest, readPrgFileSlice_sameAsReadPrgFile)
+{
+    // copied, so that the record offsets are not saved next to the test cases
+    const fs::path prgfile { "prg_slice_test.fa" };
+    fs::remove(prgfile);
+    fs::remove(prgfile.string() + ".offsets");
+    fs::copy_file(TEST_CASE_DIR + "prg4567.fa", prgfile);
+    std::vector<std::shared_ptr<LocalPRG>> all_prgs;
+    read_prg_file(all_prgs, prgfile, 3);
+
+    for (const auto& slice : { "1-3", "2/2", "0-10" }) {
+        // the second time, the offsets are read from the sidecar file
+        for (uint32_t run = 0; run != 2; ++run) {
+            std::vector<std::shared_ptr<LocalPRG>> prgs;
+            const auto prg_slice = PrgSlice::from_string(slice);
+            const auto first_prg_position
+                = read_prg_file_slice(prgs, prgfile, prg_slice, 3);
+            const auto range = prg_slice.get_range(all_prgs.size());
+            EXPECT_EQ(first_prg_position, range.first);
+            ASSERT_EQ(prgs.size(), range.second - range.first);
+            for (uint32_t i = 0; i != prgs.size(); ++i) {
+                const auto& expected_prg = all_prgs[range.first + i];
+                EXPECT_EQ(prgs[i]->id, expected_prg->id);
+                EXPECT_EQ(prgs[i]->name, expected_prg->name);
+                EXPECT_EQ(prgs[i]->seq, expected_prg->seq);
+                EXPECT_EQ(prgs[i]->prg, expected_prg->prg);
+            }
+            EXPECT_TRUE(fs::exists(prgfile.string() + ".offsets"));
+        }
+    }
+
+    const std::vector<uint64_t> expected_offsets { 0, 14, 25, 37 };
+    EXPECT_EQ(get_prg_record_offsets(prgfile), expected_offsets);
+    fs::remove(prgfile.string() + ".offsets");
+    fs::remove(prgfile);
+}
+
+TEST(UtilsTest, readPrgFileSlice_staleOffsetsFile___offsetsFoundAgain)
+{
+    const fs::path prgfile { "prg_slice_stale_test.fa" };
+    const fs::path offsets_filepath { prgfile.string() + ".offsets" };
+    fs::remove(prgfile);
+    fs::copy_file(TEST_CASE_DIR + "prg4567.fa", prgfile);
+    std::vector<std::shared_ptr<LocalPRG>> all_prgs;
+    read_prg_file(all_prgs, prgfile, 0);
+    const std::vector<uint64_t> expected_offsets { 0, 14, 25, 37 };
+
+    // offsets of a PRG file of another size, e.g. an older copy of the file
+    {
+        fs::ofstream outstream(offsets_filepath);
+        outstream << "#size 1\n0\n7\n";
+    }
+    EXPECT_EQ(get_prg_record_offsets(prgfile), expected_offsets);
+
+    // offsets saved without the size of the PRG file
+    {
+        fs::ofstream outstream(offsets_filepath);
+        outstream << "0\n7\n";
+    }
+    EXPECT_EQ(get_prg_record_offsets(prgfile), expected_offsets);
+
+    // offsets of a PRG file of the same size that do not start records
+    {
+        fs::ofstream outstream(offsets_filepath);
+        outstream << "#size " << fs::file_size(prgfile) << "\n0\n7\n16\n30\n";
+    }
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+    EXPECT_EQ(read_prg_file_slice(prgs, prgfile, PrgSlice::from_string("1-3")),
+        (uint32_t)1);
+    ASSERT_EQ(prgs.size(), (size_t)2);
+    EXPECT_EQ(prgs[0]->name, all_prgs[1]->name);
+    EXPECT_EQ(prgs[1]->name, all_prgs[2]->name);
+    EXPECT_EQ(get_prg_record_offsets(prgfile), expected_offsets);
+
+    fs::remove(offsets_filepath);
+    fs::remove(prgfile);
+}
+
+TEST(UtilsTest, readPrgFileSlice_gzippedFile___sameAsReadPrgFile)
+{
+    const fs::path prgfile { "prg_slice_test.fa.gz" };
+    {
+        std::ifstream instream(TEST_CASE_DIR + "prg4567.fa");
+        const std::string prgs_text { std::istreambuf_iterator<char>(instream),
+            std::istreambuf_iterator<char>() };
+        gzFile gzipped_prgfile = gzopen(prgfile.string().c_str(), "w");
+        ASSERT_NE(gzipped_prgfile, nullptr);
+        gzwrite(gzipped_prgfile, prgs_text.data(), prgs_text.size());
+        gzclose(gzipped_prgfile);
+    }
+    std::vector<std::shared_ptr<LocalPRG>> all_prgs;
+    read_prg_file(all_prgs, TEST_CASE_DIR + "prg4567.fa", 3);
+
+    for (const auto& slice : { "1-3", "2/2", "0-10" }) {
+        std::vector<std::shared_ptr<LocalPRG>> prgs;
+        const auto prg_slice = PrgSlice::from_string(slice);
+        const auto first_prg_position
+            = read_prg_file_slice(prgs, prgfile, prg_slice, 3);
+        const auto range = prg_slice.get_range(all_prgs.size());
+        EXPECT_EQ(first_prg_position, range.first);
+        ASSERT_EQ(prgs.size(), range.second - range.first);
+        for (uint32_t i = 0; i != prgs.size(); ++i) {
+            const auto& expected_prg = all_prgs[range.first + i];
+            EXPECT_EQ(prgs[i]->id, expected_prg->id);
+            EXPECT_EQ(prgs[i]->name, expected_prg->name);
+            EXPECT_EQ(prgs[i]->prg, expected_prg->prg);
+        }
+    }
+
+    // gzipped files are streamed, so no record offsets are saved
+    EXPECT_FALSE(fs::exists(prgfile.string() + ".offsets"));
+    fs::remove(prgfile);
+}
+
 TEST(UtilsTest, addReadHits)
 {
     // initialize minihits container
@@ -1013,6 +1204,275 @@ TEST(UtilsTest, pangraphFromReadFile_Fq)
     index->clear();
 }
 
+TEST(UtilsTest, pangraphFromReadFile_MultipleFiles___ReadIdsContinueAcrossFiles)
+{
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+
+    auto index = std::make_shared<Index>();
+    setup_index(prgs, index);
+
+    auto pangraph = std::make_shared<pangenome::Graph>(pangenome::Graph());
+    pangraph_from_read_file(
+        join_read_filepaths({ TEST_CASE_DIR + "read2.fa", TEST_CASE_DIR + "read2.fq" }),
+        pangraph, index, prgs, 1, 3, 1, 0.1, 1);
+
+    pangenome::Graph pg_exp;
+    pg_exp.add_node(prgs[1]);
+    pg_exp.add_node(prgs[2]);
+    pg_exp.add_node(prgs[3]);
+    pg_exp.add_node(prgs[0]);
+
+    EXPECT_EQ(pg_exp, *pangraph);
+    EXPECT_EQ(pangraph->reads.size(), 4);
+    EXPECT_EQ(pangraph->reads.rbegin()->first, 3);
+
+    index->clear();
+}
+
+TEST(UtilsTest, pangraphFromReadFile_QueryWindowEqualToIndexWindow)
+{
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+
+    auto index = std::make_shared<Index>();
+    setup_index(prgs, index);
+
+    auto pangraph = std::make_shared<pangenome::Graph>(pangenome::Graph());
+    pangraph_from_read_file(TEST_CASE_DIR + "read2.fa", pangraph, index, prgs, 1, 3, 1,
+        0.1, 1, 5000000, false, false, 300, 1, 1);
+
+    pangenome::Graph pg_exp;
+    pg_exp.add_node(prgs[1]);
+    pg_exp.add_node(prgs[2]);
+    pg_exp.add_node(prgs[3]);
+    pg_exp.add_node(prgs[0]);
+
+    EXPECT_EQ(pg_exp, *pangraph);
+
+    index->clear();
+}
+
+TEST(UtilsTest, pangraphFromReadFile_LargerQueryWindow___MinClusterSizeScaled)
+{
+    const std::string prg_sequence
+        = "ATGGCAATCCGAATCTTCGCGATACTTTTCTCCATTTTTTCTCTTGCCACTTTCGCGCATGCGCAAGAAGGCACGC"
+          "TAGAACGTTCTGACTGGAGGAAGTTTTTCAGCGAATTTCAAGCCAAAGGCACGATAGTTGTGGCAGACGAACGCCA"
+          "AGCGGATCGTGCCATGTTGGTTTTTGATCCTGTGCGATCGAAGAAACGCTACTCGCCTGCATCGACATTCAAGATA";
+    const uint32_t w = 1, k = 15, query_w = 9;
+    auto index = std::make_shared<Index>();
+    std::vector<std::shared_ptr<LocalPRG>> prgs {
+        std::make_shared<LocalPRG>(0, "prg", prg_sequence)
+    };
+    prgs[0]->minimizer_sketch(index, w, k);
+
+    const std::string read_filepath { "query_window_read.fa" };
+    {
+        std::ofstream outstream(read_filepath);
+        outstream << ">read\n" << prg_sequence << "\n";
+    }
+
+    // the read sketch has about 2/(query_w+1) of its k-mers, fewer than 100, so the
+    // read is only mapped because the min cluster size is scaled by (w+1)/(query_w+1)
+    auto pangraph = std::make_shared<pangenome::Graph>();
+    pangraph_from_read_file(read_filepath, pangraph, index, prgs, w, k, 100, 0.01, 100,
+        5000000, false, false, 300, 1, query_w);
+    pangenome::Graph pg_exp;
+    pg_exp.add_node(prgs[0]);
+    EXPECT_EQ(pg_exp, *pangraph);
+
+    // and is not mapped once the scaled min cluster size is above its sketch size
+    pangraph = std::make_shared<pangenome::Graph>();
+    pangraph_from_read_file(read_filepath, pangraph, index, prgs, w, k, 100, 0.01, 300,
+        5000000, false, false, 300, 1, query_w);
+    EXPECT_TRUE(pangraph->nodes.empty());
+
+    std::remove(read_filepath.c_str());
+    index->clear();
+}
+
+TEST(UtilsTest, addReadHitsWithClusterFilter_NoThresholdKeepsAllHits)
+{
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+    auto index = std::make_shared<Index>();
+    setup_index(prgs, index);
+    const Seq sequence(0, "read2", "AGTTATGCTAGCTACTTACGGTA", 1, 3);
+
+    auto all_hits = std::make_shared<MinimizerHits>();
+    add_read_hits(sequence, all_hits, *index);
+
+    auto filtered_hits = std::make_shared<MinimizerHits>();
+    const auto number_of_hits
+        = add_read_hits(sequence, filtered_hits, *index, prgs, 0, 0, 0.1);
+
+    EXPECT_EQ(all_hits->hits.size(), number_of_hits);
+    EXPECT_EQ(all_hits->hits.size(), filtered_hits->hits.size());
+
+    index->clear();
+}
+
+TEST(UtilsTest, addReadHitsWithClusterFilter_DiscardsPairsWithTooFewHits)
+{
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+    auto index = std::make_shared<Index>();
+    setup_index(prgs, index);
+    const Seq sequence(0, "read2", "AGTTATGCTAGCTACTTACGGTA", 1, 3);
+
+    auto all_hits = std::make_shared<MinimizerHits>();
+    add_read_hits(sequence, all_hits, *index);
+    std::map<std::pair<uint32_t, bool>, uint32_t> pair_to_number_of_hits;
+    for (const auto& hit : all_hits->hits) {
+        ++pair_to_number_of_hits[{ hit->get_prg_id(), hit->is_forward() }];
+    }
+
+    const uint32_t min_cluster_size = 2;
+    auto filtered_hits = std::make_shared<MinimizerHits>();
+    const auto number_of_hits = add_read_hits(
+        sequence, filtered_hits, *index, prgs, min_cluster_size, 0, 0.1);
+    EXPECT_EQ(all_hits->hits.size(), number_of_hits);
+
+    uint32_t expected_number_of_hits_kept = 0;
+    for (const auto& pair_and_number_of_hits : pair_to_number_of_hits) {
+        if (pair_and_number_of_hits.second > min_cluster_size) {
+            expected_number_of_hits_kept += pair_and_number_of_hits.second;
+        }
+    }
+    EXPECT_EQ(expected_number_of_hits_kept, filtered_hits->hits.size());
+    for (const auto& hit : filtered_hits->hits) {
+        const std::pair<uint32_t, bool> pair { hit->get_prg_id(), hit->is_forward() };
+        EXPECT_GT(pair_to_number_of_hits[pair], min_cluster_size);
+    }
+
+    auto no_hits = std::make_shared<MinimizerHits>();
+    add_read_hits(sequence, no_hits, *index, prgs, 1000, 0, 0.1);
+    EXPECT_TRUE(no_hits->hits.empty());
+
+    index->clear();
+}
+
+TEST(UtilsTest, getQuerySketchDensityRatio_SameWindow)
+{
+    EXPECT_FLOAT_EQ(get_query_sketch_density_ratio(14, 14), 1);
+}
+
+TEST(UtilsTest, getQuerySketchDensityRatio_LargerQueryWindow)
+{
+    EXPECT_FLOAT_EQ(get_query_sketch_density_ratio(14, 29), 0.5);
+}
+
+TEST(UtilsTest, getQuerySketchDensityRatio_SmallerQueryWindow___expects_FatalRuntimeError)
+{
+    ASSERT_EXCEPTION(get_query_sketch_density_ratio(14, 13), FatalRuntimeError,
+        "must not be smaller than the index window size");
+}
+
+TEST(UtilsTest, getExpectedNumberKmersInReadSketch_Minimizers)
+{
+    EXPECT_EQ(get_expected_number_kmers_in_read_sketch(150, 14, 15, 0), (uint)20);
+}
+
+TEST(UtilsTest, getExpectedNumberKmersInReadSketch_SyncmersIgnoreWindow)
+{
+    EXPECT_EQ(get_expected_number_kmers_in_read_sketch(150, 14, 15, 11), (uint)30);
+    EXPECT_EQ(get_expected_number_kmers_in_read_sketch(150, 1, 15, 11), (uint)30);
+}
+
+TEST(UtilsTest, pangraphFromReadFile_SyncmerIndex___ReadShorterThanPrgMapped)
+{
+    const std::string prg_sequence
+        = "ATGGCAATCCGAATCTTCGCGATACTTTTCTCCATTTTTTCTCTTGCCACTTTCGCGCATGCGCAAGAAGGCACGC"
+          "TAGAACGTTCTGACTGGAGGAAGTTTTTCAGCGAATTTCAAGCCAAAGGCACGATAGTTGTGGCAGACGAACGCCA"
+          "AGCGGATCGTGCCATGTTGGTTTTTGATCCTGTGCGATCGAAGAAACGCTACTCGCCTGCATCGACATTCAAGATA";
+    const uint32_t w = 1, k = 15, syncmer_size = 11;
+    auto index = std::make_shared<Index>();
+    index->syncmer_size = syncmer_size;
+    std::vector<std::shared_ptr<LocalPRG>> prgs {
+        std::make_shared<LocalPRG>(0, "prg", prg_sequence)
+    };
+    prgs[0]->syncmer_sketch(index, k, syncmer_size);
+
+    // the read only covers part of the PRG, so the cluster size threshold comes from
+    // the expected number of syncmers of the read, 1/(k-s+1) of its bases
+    const std::string read_filepath { "syncmer_read.fa" };
+    {
+        std::ofstream outstream(read_filepath);
+        outstream << ">read\n" << prg_sequence.substr(60, 80) << "\n";
+    }
+
+    auto pangraph = std::make_shared<pangenome::Graph>();
+    pangraph_from_read_file(
+        read_filepath, pangraph, index, prgs, w, k, 100, 0.01, 1, 5000000);
+
+    pangenome::Graph pg_exp;
+    pg_exp.add_node(prgs[0]);
+    EXPECT_EQ(pg_exp, *pangraph);
+
+    std::remove(read_filepath.c_str());
+    index->clear();
+}
+
+TEST(UtilsTest, pangraphFromReadFile_SubsampleNoReads___EmptyPangraph)
+{
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+
+    auto index = std::make_shared<Index>();
+    setup_index(prgs, index);
+
+    auto pangraph = std::make_shared<pangenome::Graph>(pangenome::Graph());
+    pangraph_from_read_file(TEST_CASE_DIR + "read2.fa", pangraph, index, prgs, 1, 3, 1,
+        0.1, 1, 5000000, false, false, 300, 1, 1, 0);
+
+    EXPECT_TRUE(pangraph->nodes.empty());
+
+    index->clear();
+}
+
+TEST(UtilsTest, pangraphFromReadFile_TargetCovgReachedByFirstRead___OnlyFirstReadMapped)
+{
+    std::vector<std::shared_ptr<LocalPRG>> prgs;
+
+    auto index = std::make_shared<Index>();
+    setup_index(prgs, index);
+
+    // both reads have 23 bases, so the first one alone covers a genome of 23 bases
+    for (const uint32_t threads : { 1, 2 }) {
+        auto pangraph = std::make_shared<pangenome::Graph>(pangenome::Graph());
+        const uint32_t covg = pangraph_from_read_file(TEST_CASE_DIR + "read2.fa",
+            pangraph, index, prgs, 1, 3, 1, 0.1, 1, 23, false, false, 300, threads, 1,
+            1, 1);
+
+        EXPECT_EQ(covg, (uint)1);
+        EXPECT_EQ(pangraph->reads.size(), (uint)1);
+        EXPECT_EQ(pangraph->reads.count(0), (uint)1);
+    }
+
+    auto pangraph = std::make_shared<pangenome::Graph>(pangenome::Graph());
+    const uint32_t covg = pangraph_from_read_file(TEST_CASE_DIR + "read2.fa", pangraph,
+        index, prgs, 1, 3, 1, 0.1, 1, 23, false, false, 300, 1, 1, 1, 0);
+    EXPECT_EQ(covg, (uint)2);
+    EXPECT_EQ(pangraph->reads.size(), (uint)2);
+
+    index->clear();
+}
+
+TEST(UtilsTest, readIsKeptWhenSubsampling_AllOrNothing)
+{
+    EXPECT_TRUE(read_is_kept_when_subsampling("read_1", 1));
+    EXPECT_FALSE(read_is_kept_when_subsampling("read_1", 0));
+}
+
+TEST(UtilsTest, readIsKeptWhenSubsampling_KeepsApproximatelyTheFraction)
+{
+    uint32_t nb_kept = 0;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        const std::string read_name = "read_" + std::to_string(i);
+        const bool kept = read_is_kept_when_subsampling(read_name, 0.25);
+        EXPECT_EQ(kept, read_is_kept_when_subsampling(read_name, 0.25));
+        nb_kept += kept;
+    }
+
+    EXPECT_GT(nb_kept, 2250);
+    EXPECT_LT(nb_kept, 2750);
+}
+
 TEST(StrToGsTest, HandlesEmptyStr)
 {
     const char* str { "" };
@@ -1204,6 +1664,26 @@ TEST(load_read_index, read_index_has_three_samples)
     EXPECT_EQ(actual, expected);
 }
 
+TEST(load_read_index, read_index_has_sample_with_multiple_files)
+{
+    std::vector<std::pair<SampleIdText, SampleFpath>> actual = load_read_index(
+        fs::path("../../test/test_cases/sample_read_index_with_multiple_files.tsv"));
+    std::vector<std::pair<SampleIdText, SampleFpath>> expected { {
+        std::make_pair("sample_1", "reads_1_R1.fastq,reads_1_R2.fastq"),
+        std::make_pair("sample_2", "reads_2.fastq"),
+    } };
+
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(UtilsTest, joinReadFilepaths)
+{
+    EXPECT_EQ(join_read_filepaths({}), "");
+    EXPECT_EQ(join_read_filepaths({ "reads.fq" }), "reads.fq");
+    EXPECT_EQ(join_read_filepaths({ "/a/reads_1.fq", "reads_2.fq.gz" }),
+        "/a/reads_1.fq,reads_2.fq.gz");
+}
+
 TEST(load_read_index, read_index_has_three_samples_and_two_are_repeated)
 {
     std::vector<std::pair<SampleIdText, SampleFpath>> actual = load_read_index(
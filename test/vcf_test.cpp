@@ -1492,6 +1492,56 @@ TEST(VCFTest___merge_multi_allelic,
             2));
 }
 
+TEST(VCFTest___merge_multi_allelic_in_place, same_output_as_merge_multi_allelic)
+{
+    VCF vcf = create_VCF_with_default_parameters(0);
+    vcf.add_samples({ "sample1", "sample2" });
+    vcf.add_record("chrom1", 5, "A", "C", "SVTYPE=SNP", "GRAPHTYPE=SIMPLE");
+    vcf.add_record("chrom1", 5, "A", "G", "SVTYPE=SNP", "GRAPHTYPE=SIMPLE");
+    vcf.add_record("chrom1", 9, "T", "C", "SVTYPE=SNP", "GRAPHTYPE=SIMPLE");
+    vcf.add_record("chrom1", 1, "G", "C", "SVTYPE=SNP", "GRAPHTYPE=SIMPLE");
+    vcf.get_records()[0]->sampleIndex_to_sampleInfo[0].set_coverage_information(
+        { { 1 }, { 2 } }, { { 0 }, { 0 } });
+    vcf.get_records()[1]->sampleIndex_to_sampleInfo[0].set_coverage_information(
+        { { 1 }, { 4 } }, { { 0 }, { 0 } });
+
+    VCF expected = vcf.merge_multi_allelic();
+    vcf.merge_multi_allelic_in_place();
+
+    EXPECT_EQ(3, vcf.get_VCF_size());
+    EXPECT_EQ(expected.to_string(true, false), vcf.to_string(true, false));
+}
+
+TEST(VCFTest___merge_multi_allelic_in_place, nothing_to_merge___records_are_kept)
+{
+    VCF vcf = create_VCF_with_default_parameters(0);
+    vcf.add_samples({ "sample1" });
+    vcf.add_record("chrom1", 5, "A", "C", "SVTYPE=SNP", "GRAPHTYPE=SIMPLE");
+    vcf.add_record("chrom1", 9, "T", "C", "SVTYPE=SNP", "GRAPHTYPE=SIMPLE");
+    const VCFRecord* first_record = vcf.get_records()[0].get();
+    const VCFRecord* second_record = vcf.get_records()[1].get();
+
+    vcf.merge_multi_allelic_in_place();
+
+    EXPECT_EQ(2, vcf.get_VCF_size());
+    EXPECT_EQ(first_record, vcf.get_records()[0].get());
+    EXPECT_EQ(second_record, vcf.get_records()[1].get());
+}
+
+TEST(VCFTest___merge_multi_allelic_in_place, nothing_to_merge___records_are_sorted)
+{
+    VCF vcf = create_VCF_with_default_parameters(0);
+    vcf.add_samples({ "sample1" });
+    vcf.add_record("chrom1", 9, "T", "C", "SVTYPE=SNP", "GRAPHTYPE=SIMPLE");
+    vcf.add_record("chrom1", 5, "A", "C", "SVTYPE=SNP", "GRAPHTYPE=SIMPLE");
+
+    vcf.merge_multi_allelic_in_place();
+
+    EXPECT_EQ(2, vcf.get_VCF_size());
+    EXPECT_EQ(5, vcf.get_records()[0]->get_pos());
+    EXPECT_EQ(9, vcf.get_records()[1]->get_pos());
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // OLD merge_multi_allelic TESTS - TO BE READDED AS INTEGRATION TESTS
@@ -1647,6 +1697,56 @@ TEST(VCFTest, correct_dot_alleles)
     EXPECT_EQ(vcf.get_records()[7]->get_alts()[0], "TTA");
 }
 
+TEST(VCFTest, correct_dot_alleles_in_place___same_output_as_correct_dot_alleles)
+{
+    VCF vcf = create_VCF_with_default_parameters(0);
+    vcf.add_a_new_record_discovered_in_a_sample_and_genotype_it(
+        "sample", "chrom1", 0, ".", "TA");
+    vcf.add_a_new_record_discovered_in_a_sample_and_genotype_it(
+        "sample", "chrom2", 0, "T", ".");
+    vcf.add_a_new_record_discovered_in_a_sample_and_genotype_it(
+        "sample", "chrom1", 35, ".", "A");
+    vcf.add_a_new_record_discovered_in_a_sample_and_genotype_it(
+        "sample", "chrom1", 44, "TA", "T");
+    vcf.add_a_new_record_discovered_in_a_sample_and_genotype_it(
+        "sample", "chrom1", 44, "TA", ".");
+    vcf.add_a_new_record_discovered_in_a_sample_and_genotype_it(
+        "sample", "chrom1", 50, "T", "G");
+
+    string vcf_ref = "TATATGTGTC"
+                     "GCGACACTGC"
+                     "ATGCATGCAT"
+                     "AGTCCTAAAG"
+                     "TCCTTAAACG"
+                     "TTTATAGTCG";
+
+    // correct_dot_alleles() modifies the records it is given, so work on a copy
+    VCF expected = create_VCF_with_default_parameters(0);
+    expected.append_vcf(vcf);
+    expected = expected.correct_dot_alleles(vcf_ref, "chrom1");
+    vcf.correct_dot_alleles_in_place(vcf_ref, "chrom1");
+
+    EXPECT_EQ(6, vcf.get_VCF_size());
+    EXPECT_EQ(expected.to_string(true, false), vcf.to_string(true, false));
+}
+
+TEST(VCFTest, correct_dot_alleles_in_place___no_dot_alleles___records_are_kept)
+{
+    VCF vcf = create_VCF_with_default_parameters(0);
+    vcf.add_a_new_record_discovered_in_a_sample_and_genotype_it(
+        "sample", "chrom1", 35, "T", "A");
+    vcf.add_a_new_record_discovered_in_a_sample_and_genotype_it(
+        "sample", "chrom2", 0, "T", ".");
+    const VCFRecord* first_record = vcf.get_records()[0].get();
+
+    vcf.correct_dot_alleles_in_place(
+        "TATATGTGTCGCGACACTGCATGCATGCATAGTCCTAAAG", "chrom1");
+
+    EXPECT_EQ(2, vcf.get_VCF_size());
+    EXPECT_EQ(first_record, vcf.get_records()[0].get());
+    EXPECT_EQ(".", vcf.get_records()[1]->get_alts()[0]);
+}
+
 class VCFTest___make_gt_compatible___Fixture : public ::testing::Test {
 public:
     class VCFRecordMock : public VCFRecord {